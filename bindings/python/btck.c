@@ -39,6 +39,8 @@ static int exec(PyObject* module)
     return -1;
   }
 
+  TransactionOutput_Init();
+
   for (int idx = 0; idx < Py_ARRAY_LENGTH(types); ++idx) {
     if (PyModule_AddType(module, types[idx]) < 0) {
       return -1;
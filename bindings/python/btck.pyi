@@ -3,6 +3,7 @@
 # file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 from __future__ import annotations
+import os
 import typing
 
 
@@ -57,11 +58,30 @@ class BlockHash:
 
 @typing.final
 class Chain:
-    #def __init__(self): ...
+    def __init__(self,
+        data_dir: str,
+        blocks_dir: str | None = None,
+        *,
+        chain_type: int = 0,
+        cache_bytes: int = 0,
+        block_cache_bytes: int = 0,
+        max_open_block_files: int = 0,
+        worker_threads: int = 0,
+        block_tree_db_in_memory: bool = False,
+        chainstate_db_in_memory: bool = False,
+        obfuscate_block_files: bool = True,
+    ): ...
     blocks: _Slice[Block]
+    block_cache_stats: dict[str, int]
     def find(self, _: BlockHash) -> int: ...
     def index(self, _: BlockHash) -> int: ...
-    #def import_blocks(self, paths: typing.Iterable[str]) -> bool: ...
+    def import_blocks(
+        self,
+        paths: typing.Iterable[str | bytes | os.PathLike[str]],
+        progress: typing.Callable[[int, int], None] | None = None,
+        *,
+        num_threads: int = 0,
+    ) -> int: ...
     #def process_block(self, block: Block) -> tuple[bool, bool]: ...
 
 
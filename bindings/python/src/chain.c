@@ -16,25 +16,33 @@
 struct Self {
   PyObject_HEAD
   struct BtcK_Chain* impl;
+  // Imports run without the GIL and must not overlap.
+  int importing;
 };
 
 static void dealloc(struct Self* self);
 static PyObject* new(PyTypeObject* type, PyObject* args, PyObject* kwargs);
 static PyObject* get_blocks(struct Self const* self, void* closure);
+static PyObject* get_block_cache_stats(struct Self const* self, void* closure);
 
 static Py_ssize_t num_blocks(struct Self const* self);
 static PyObject* get_block(struct Self* self, Py_ssize_t idx);
 static PyObject* find_block(struct Self const* self, PyObject* args);
 static PyObject* block_index(struct Self const* self, PyObject* args);
+static PyObject* import_blocks(
+  struct Self* self, PyObject* args, PyObject* kwargs);
 
 static PyGetSetDef getset[] = {
   {"blocks", (getter)get_blocks, NULL, "", NULL},
+  {"block_cache_stats", (getter)get_block_cache_stats, NULL, "", NULL},
   {},
 };
 
 static PyMethodDef blocks_methods[] = {
   {"index", (PyCFunction)block_index, METH_VARARGS, ""},
   {"find", (PyCFunction)find_block, METH_VARARGS, ""},
+  {"import_blocks", (PyCFunction)import_blocks, METH_VARARGS | METH_KEYWORDS,
+   ""},
   {},
 };
 
@@ -59,34 +67,157 @@ static void dealloc(struct Self* self)
 static PyObject* new(
   PyTypeObject* Py_UNUSED(type), PyObject* args, PyObject* kwargs)
 {
-  //   ChainMan(
-  //       Context const& context, ChainstateManagerOptions const& chainman_opts)
-  //       noexcept
-  //     : m_chainman{kernel_chainstate_manager_create(
-  //           context.m_context.get(), chainman_opts.m_options.get())}
-  //     , m_context{context}
-  //   {}
-  return NULL;
+  static char* kwlist[] = {
+    "data_dir",
+    "blocks_dir",
+    "chain_type",
+    "cache_bytes",
+    "block_cache_bytes",
+    "max_open_block_files",
+    "worker_threads",
+    "block_tree_db_in_memory",
+    "chainstate_db_in_memory",
+    "obfuscate_block_files",
+    NULL,
+  };
+
+  struct BtcK_ChainOptions options = {};
+  Py_ssize_t cache_bytes = 0;
+  Py_ssize_t block_cache_bytes = 0;
+  Py_ssize_t max_open_block_files = 0;
+  int obfuscate_block_files = 1;
+  if (!PyArg_ParseTupleAndKeywords(
+        args, kwargs, "s|z$Bnnnippp", kwlist, &options.data_dir,
+        &options.blocks_dir, &options.chain_type, &cache_bytes,
+        &block_cache_bytes, &max_open_block_files, &options.worker_threads,
+        &options.block_tree_db_in_memory, &options.chainstate_db_in_memory,
+        &obfuscate_block_files)) {
+    return NULL;
+  }
+  options.disable_block_file_obfuscation = !obfuscate_block_files;
+  if (cache_bytes < 0 || block_cache_bytes < 0) {
+    PyErr_SetString(PyExc_ValueError, "cache sizes must not be negative");
+    return NULL;
+  }
+  if (max_open_block_files < 0) {
+    PyErr_SetString(
+      PyExc_ValueError, "max_open_block_files must not be negative");
+    return NULL;
+  }
+  options.cache_bytes = (size_t)cache_bytes;
+  options.block_cache_bytes = (size_t)block_cache_bytes;
+  options.max_open_block_files = (size_t)max_open_block_files;
+
+  struct BtcK_Error* err = NULL;
+  struct BtcK_Chain* impl = BtcK_Chain_New(&options, &err);
+  if (err != NULL) {
+    return SetError(err);
+  }
+
+  struct Self* self = PyObject_New(struct Self, &Chain_Type);
+  if (self == NULL) {
+    BtcK_Chain_Free(impl);
+    return NULL;
+  }
+  self->impl = impl;
+  self->importing = 0;
+  return (PyObject*)self;
 }
 
-//   bool ImportBlocks(std::span<std::string const> const paths) const noexcept
-//   {
-//     std::vector<char const*> c_paths;
-//     std::vector<size_t> c_paths_lens;
-//     c_paths.reserve(paths.size());
-//     c_paths_lens.reserve(paths.size());
-//     for (auto const& path : paths) {
-//       c_paths.push_back(path.c_str());
-//       c_paths_lens.push_back(path.length());
-//     }
-
-//     return kernel_import_blocks(
-//         m_context.m_context.get(),
-//         m_chainman,
-//         c_paths.data(),
-//         c_paths_lens.data(),
-//         c_paths.size());
-//   }
+// Called on the importing thread, which released the GIL. An exception is
+// left set for import_blocks to raise.
+static int import_progress(size_t done, size_t total, void* userdata)
+{
+  PyGILState_STATE const gil = PyGILState_Ensure();
+  PyObject* const result = PyObject_CallFunction(
+    (PyObject*)userdata, "nn", (Py_ssize_t)done, (Py_ssize_t)total);
+  Py_XDECREF(result);
+  PyGILState_Release(gil);
+  return result != NULL ? 0 : -1;
+}
+
+static void free_paths(PyObject** encoded, Py_ssize_t count)
+{
+  for (Py_ssize_t i = 0; i < count; ++i) {
+    Py_DECREF(encoded[i]);
+  }
+  PyMem_Free(encoded);
+}
+
+static PyObject* import_blocks(
+  struct Self* self, PyObject* args, PyObject* kwargs)
+{
+  static char* kwlist[] = {"paths", "progress", "num_threads", NULL};
+
+  PyObject* paths = NULL;
+  PyObject* progress = Py_None;
+  Py_ssize_t num_threads = 0;
+  if (!PyArg_ParseTupleAndKeywords(
+        args, kwargs, "O|O$n", kwlist, &paths, &progress, &num_threads)) {
+    return NULL;
+  }
+  if (progress != Py_None && !PyCallable_Check(progress)) {
+    PyErr_SetString(PyExc_TypeError, "progress must be callable");
+    return NULL;
+  }
+  if (num_threads < 0) {
+    PyErr_SetString(PyExc_ValueError, "num_threads must not be negative");
+    return NULL;
+  }
+
+  if (self->importing) {
+    PyErr_SetString(PyExc_RuntimeError, "import already running");
+    return NULL;
+  }
+
+  // Paths are encoded like the os module does, so that any str, bytes or
+  // path-like object names the same file as it would there.
+  PyObject* const seq = PySequence_Fast(paths, "paths must be iterable");
+  if (seq == NULL) {
+    return NULL;
+  }
+  Py_ssize_t const count = PySequence_Fast_GET_SIZE(seq);
+  PyObject** encoded = PyMem_New(PyObject*, count + 1);
+  char const** c_paths = PyMem_New(char const*, count + 1);
+  if (encoded == NULL || c_paths == NULL) {
+    PyMem_Free(encoded);
+    PyMem_Free(c_paths);
+    Py_DECREF(seq);
+    return PyErr_NoMemory();
+  }
+  for (Py_ssize_t i = 0; i < count; ++i) {
+    PyObject* const path = PySequence_Fast_GET_ITEM(seq, i);
+    if (!PyUnicode_FSConverter(path, &encoded[i])) {
+      free_paths(encoded, i);
+      PyMem_Free(c_paths);
+      Py_DECREF(seq);
+      return NULL;
+    }
+    c_paths[i] = PyBytes_AS_STRING(encoded[i]);
+  }
+  Py_DECREF(seq);
+
+  size_t skipped = 0;
+  struct BtcK_Error* err = NULL;
+  int result = 0;
+  self->importing = 1;
+  Py_BEGIN_ALLOW_THREADS
+  result = BtcK_Chain_ImportBlocks(
+    self->impl, c_paths, (size_t)count, (size_t)num_threads,
+    progress != Py_None ? import_progress : NULL, progress, &skipped, &err);
+  Py_END_ALLOW_THREADS
+  self->importing = 0;
+  free_paths(encoded, count);
+  PyMem_Free(c_paths);
+  if (result != 0) {
+    if (PyErr_Occurred()) {
+      BtcK_Error_Free(err);
+      return NULL;
+    }
+    return SetError(err);
+  }
+  return PyLong_FromSize_t(skipped);
+}
 
 //   bool ProcessBlock(Block const& block, bool* new_block) const noexcept
 //   {
@@ -110,6 +241,17 @@ static PyObject* get_blocks(struct Self const* self, void* Py_UNUSED(closure))
   return Slice_New((PyObject*)self, length, (ssizeargfunc)block_item);
 }
 
+static PyObject* get_block_cache_stats(
+  struct Self const* self, void* Py_UNUSED(closure))
+{
+  struct BtcK_BlockCacheStats stats;
+  BtcK_Chain_GetBlockCacheStats(self->impl, &stats);
+  return Py_BuildValue(
+    "{s:K,s:K,s:n,s:n}", "hits", (unsigned long long)stats.hits, "misses",
+    (unsigned long long)stats.misses, "entries", (Py_ssize_t)stats.entries,
+    "bytes", (Py_ssize_t)stats.bytes);
+}
+
 static PyObject* block_index(struct Self const* self, PyObject* args)
 {
   PyObject* block_hash = NULL;
@@ -79,13 +79,17 @@ static PyObject* str(struct Self const* self)
 
 static PyObject* outputs_item(struct Self* self, Py_ssize_t idx)
 {
+  // The shared output holds the script by reference, so only the handle is
+  // copied into the Python object.
   struct BtcK_Error* err = NULL;
-  struct BtcK_TransactionOutput* ptr = BtcK_TransactionOutput_Copy(
-    BtcK_Transaction_GetOutput(self->impl, idx), &err);
+  struct BtcK_TransactionOutput* ref =
+    BtcK_Transaction_GetOutputRef(self->impl, (size_t)idx, &err);
   if (err != NULL) {
     return SetError(err);
   }
-  return TransactionOutput_New(ptr);
+  PyObject* output = TransactionOutput_New(ref);
+  BtcK_TransactionOutput_Free(ref);
+  return output;
 }
 
 static PyObject* get_outputs(struct Self const* self, void* Py_UNUSED(closure))
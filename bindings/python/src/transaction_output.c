@@ -13,11 +13,15 @@
 #include "_util.h"
 #include "script_pubkey.h"
 
+// The BtcK_TransactionOutput is constructed in place at `impl_offset`, right
+// behind the Python object header, so each object is a single allocation.
 struct Self {
   PyObject_HEAD
   struct BtcK_TransactionOutput* impl;
 };
 
+static Py_ssize_t impl_offset = 0;
+
 static void dealloc(struct Self* self);
 static PyObject* new(PyTypeObject* type, PyObject* args, PyObject* kwargs);
 static PyObject* str(struct Self const* self);
@@ -42,9 +46,14 @@ PyTypeObject TransactionOutput_Type = {
   .tp_getset = getset,
 };
 
+static void* storage(struct Self* self)
+{
+  return (char*)self + impl_offset;
+}
+
 static void dealloc(struct Self* self)
 {
-  BtcK_TransactionOutput_Free(self->impl);
+  BtcK_TransactionOutput_Destroy(self->impl);
   Py_TYPE(self)->tp_free((PyObject*)self);
 }
 
@@ -61,8 +70,19 @@ static PyObject* new(
     return NULL;
   }
 
-  return TransactionOutput_New(BtcK_TransactionOutput_New(
-    amount, ScriptPubkey_GetImpl(script_pubkey), NULL));
+  struct Self* self = PyObject_New(struct Self, &TransactionOutput_Type);
+  if (self == NULL) {
+    return NULL;
+  }
+
+  struct BtcK_Error* err = NULL;
+  self->impl = BtcK_TransactionOutput_InitAt(
+    storage(self), amount, ScriptPubkey_GetImpl(script_pubkey), &err);
+  if (err != NULL) {
+    Py_DECREF(self);
+    return SetError(err);
+  }
+  return (PyObject*)self;
 }
 
 static PyObject* str(struct Self const* self)
@@ -88,14 +108,28 @@ static PyObject* get_script_pubkey(
   return ScriptPubkey_New(ptr);
 }
 
-PyObject* TransactionOutput_New(struct BtcK_TransactionOutput* txout)
+void TransactionOutput_Init(void)
+{
+  size_t const align = BtcK_TransactionOutput_AlignOf();
+  impl_offset =
+    (Py_ssize_t)((sizeof(struct Self) + align - 1) / align * align);
+  TransactionOutput_Type.tp_basicsize =
+    impl_offset + (Py_ssize_t)BtcK_TransactionOutput_SizeOf();
+}
+
+PyObject* TransactionOutput_New(struct BtcK_TransactionOutput const* txout)
 {
   struct Self* self = PyObject_New(struct Self, &TransactionOutput_Type);
   if (self == NULL) {
-    BtcK_TransactionOutput_Free(txout);
     return NULL;
   }
-  self->impl = txout;
+
+  struct BtcK_Error* err = NULL;
+  self->impl = BtcK_TransactionOutput_CopyAt(storage(self), txout, &err);
+  if (err != NULL) {
+    Py_DECREF(self);
+    return SetError(err);
+  }
   return (PyObject*)self;
 }
 
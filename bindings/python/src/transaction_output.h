@@ -10,5 +10,6 @@ struct BtcK_TransactionOutput;
 
 extern PyTypeObject TransactionOutput_Type;
 
-PyObject* TransactionOutput_New(struct BtcK_TransactionOutput* txout);
+void TransactionOutput_Init(void);
+PyObject* TransactionOutput_New(struct BtcK_TransactionOutput const* txout);
 struct BtcK_TransactionOutput* TransactionOutput_GetImpl(PyObject* object);
@@ -25,8 +25,16 @@
 extern "C" {
 #endif
 
+struct BtcK_ArchiveReader;
+struct BtcK_ArchiveWriter;
+struct BtcK_Arena;
 struct BtcK_Block;
+struct BtcK_BlockUndo;
 struct BtcK_Chain;
+struct BtcK_ChainCursor;
+struct BtcK_ChainSnapshot;
+struct BtcK_FlatBlock;
+struct BtcK_RawBlock;
 struct BtcK_ScriptPubkey;
 struct BtcK_Transaction;
 struct BtcK_TransactionOutput;
@@ -38,6 +46,12 @@ BTCK_API struct BtcK_Error* BtcK_Error_New(
 
 BTCK_API void BtcK_Error_Free(struct BtcK_Error* error);
 
+// A per-thread slot to pass as `err`. Errors reported there are never
+// allocated and need not be freed; each overwrites the previous one. Every
+// call that takes the slot resets it to null first, so it only holds an error
+// when the last such call on this thread failed.
+BTCK_API struct BtcK_Error** BtcK_Error_ThreadLocal(void);
+
 BTCK_API int BtcK_Error_Code(struct BtcK_Error const* error);
 BTCK_API char const* BtcK_Error_Domain(struct BtcK_Error const* error);
 BTCK_API char const* BtcK_Error_Message(struct BtcK_Error const* error);
@@ -46,6 +60,37 @@ typedef int (*BtcK_WriteBytes)(void const* bytes, size_t size, void* userdata);
 
 /*****************************************************************************/
 
+// The allocator must return memory aligned like malloc, to at least
+// alignof(max_align_t), or null on failure. BtcK_SetAllocator only succeeds
+// before the library first allocates, later calls return -1 and leave the
+// default allocator in place. It is safe to call concurrently with other
+// functions, but installing it before any other call is the reliable way.
+typedef void* (*BtcK_AllocateFn)(size_t size, void* userdata);
+typedef void (*BtcK_DeallocateFn)(void* ptr, void* userdata);
+
+BTCK_API int BtcK_SetAllocator(
+  BtcK_AllocateFn allocate, BtcK_DeallocateFn deallocate, void* userdata);
+
+/*****************************************************************************/
+
+typedef uint8_t BtcK_ObjectType;
+
+#define BtcK_ObjectType_SCRIPT_PUBKEY ((BtcK_ObjectType)(0))
+#define BtcK_ObjectType_TRANSACTION_OUTPUT ((BtcK_ObjectType)(1))
+#define BtcK_ObjectType_TRANSACTION ((BtcK_ObjectType)(2))
+#define BtcK_ObjectType_BLOCK ((BtcK_ObjectType)(3))
+#define BtcK_ObjectType_FLAT_BLOCK ((BtcK_ObjectType)(4))
+
+struct BtcK_MemoryStats {
+  size_t live_objects;
+  size_t live_bytes;
+};
+
+BTCK_API int BtcK_GetMemoryStats(
+  BtcK_ObjectType type, struct BtcK_MemoryStats* out);
+
+/*****************************************************************************/
+
 typedef uint8_t BtcK_VerificationError;
 
 #define BtcK_VerificationError_TX_INPUT_INDEX ((BtcK_VerificationError)(1))
@@ -99,6 +144,36 @@ BTCK_API int BtcK_VerificationFlags_ToString(
 
 /*****************************************************************************/
 
+typedef uint32_t BtcK_JsonOptions;
+
+#define BtcK_JsonOptions_NONE ((BtcK_JsonOptions)(0))
+
+#define BtcK_JsonOptions_VERBOSE ((BtcK_JsonOptions)(1U << 0))
+
+#define BtcK_JsonOptions_DECODE_SCRIPTS ((BtcK_JsonOptions)(1U << 1))
+
+#define BtcK_JsonOptions_WITNESS ((BtcK_JsonOptions)(1U << 2))
+
+#define BtcK_JsonOptions_TX_HEX ((BtcK_JsonOptions)(1U << 3))
+
+#define BtcK_JsonOptions_ALL                                                   \
+  ((BtcK_JsonOptions)(BtcK_JsonOptions_VERBOSE |                               \
+                      BtcK_JsonOptions_DECODE_SCRIPTS |                        \
+                      BtcK_JsonOptions_WITNESS | BtcK_JsonOptions_TX_HEX))
+
+/*****************************************************************************/
+
+typedef uint8_t BtcK_ExportFormat;
+
+#define BtcK_ExportFormat_BYTES ((BtcK_ExportFormat)(0))
+
+#define BtcK_ExportFormat_JSON ((BtcK_ExportFormat)(1))
+
+typedef int (*BtcK_ExportSink)(
+  size_t idx, void const* bytes, size_t size, void* userdata);
+
+/*****************************************************************************/
+
 #define BtcK_BlockHash_SIZE 32
 struct BtcK_BlockHash {
   unsigned char data[BtcK_BlockHash_SIZE];
@@ -109,14 +184,53 @@ BTCK_API void BtcK_BlockHash_Init(
 
 /*****************************************************************************/
 
+// Objects created with the *_NewIn and *_CopyIn functions belong to the arena
+// and are destroyed by BtcK_Arena_Reset and BtcK_Arena_Free. They must not be
+// passed to their *_Free or *_Destroy function, debug builds assert on it.
+BTCK_API struct BtcK_Arena* BtcK_Arena_New(struct BtcK_Error** err);
+
+BTCK_API void BtcK_Arena_Reset(struct BtcK_Arena* self);
+
+BTCK_API void BtcK_Arena_Free(struct BtcK_Arena* self);
+
+/*****************************************************************************/
+
 BTCK_API struct BtcK_ScriptPubkey* BtcK_ScriptPubkey_New(
   void const* raw, size_t len, struct BtcK_Error** err);
 
+BTCK_API struct BtcK_ScriptPubkey* BtcK_ScriptPubkey_NewIn(
+  struct BtcK_Arena* arena, void const* raw, size_t len,
+  struct BtcK_Error** err);
+
 BTCK_API struct BtcK_ScriptPubkey* BtcK_ScriptPubkey_Copy(
   struct BtcK_ScriptPubkey const* self, struct BtcK_Error** err);
 
+BTCK_API struct BtcK_ScriptPubkey* BtcK_ScriptPubkey_CopyIn(
+  struct BtcK_Arena* arena, struct BtcK_ScriptPubkey const* self,
+  struct BtcK_Error** err);
+
 BTCK_API void BtcK_ScriptPubkey_Free(struct BtcK_ScriptPubkey* self);
 
+BTCK_API size_t BtcK_ScriptPubkey_SizeOf(void);
+
+BTCK_API size_t BtcK_ScriptPubkey_AlignOf(void);
+
+BTCK_API struct BtcK_ScriptPubkey* BtcK_ScriptPubkey_InitAt(
+  void* storage, void const* raw, size_t len, struct BtcK_Error** err);
+
+BTCK_API struct BtcK_ScriptPubkey* BtcK_ScriptPubkey_CopyAt(
+  void* storage, struct BtcK_ScriptPubkey const* self, struct BtcK_Error** err);
+
+BTCK_API void BtcK_ScriptPubkey_Destroy(struct BtcK_ScriptPubkey* self);
+
+BTCK_API struct BtcK_ScriptPubkey const* BtcK_ScriptPubkey_Intern(
+  struct BtcK_ScriptPubkey const* self, struct BtcK_Error** err);
+
+BTCK_API void BtcK_ScriptPubkey_Release(struct BtcK_ScriptPubkey const* self);
+
+BTCK_API size_t
+BtcK_ScriptPubkey_DynamicMemoryUsage(struct BtcK_ScriptPubkey const* self);
+
 BTCK_API int BtcK_ScriptPubkey_Equal(
   struct BtcK_ScriptPubkey const* left, struct BtcK_ScriptPubkey const* right);
 
@@ -136,11 +250,37 @@ BTCK_API struct BtcK_TransactionOutput* BtcK_TransactionOutput_New(
   int64_t amount, struct BtcK_ScriptPubkey const* script_pubkey,
   struct BtcK_Error** err);
 
+BTCK_API struct BtcK_TransactionOutput* BtcK_TransactionOutput_NewIn(
+  struct BtcK_Arena* arena, int64_t amount,
+  struct BtcK_ScriptPubkey const* script_pubkey, struct BtcK_Error** err);
+
 BTCK_API struct BtcK_TransactionOutput* BtcK_TransactionOutput_Copy(
   struct BtcK_TransactionOutput const* self, struct BtcK_Error** err);
 
+BTCK_API struct BtcK_TransactionOutput* BtcK_TransactionOutput_CopyIn(
+  struct BtcK_Arena* arena, struct BtcK_TransactionOutput const* self,
+  struct BtcK_Error** err);
+
 BTCK_API void BtcK_TransactionOutput_Free(struct BtcK_TransactionOutput* self);
 
+BTCK_API size_t BtcK_TransactionOutput_SizeOf(void);
+
+BTCK_API size_t BtcK_TransactionOutput_AlignOf(void);
+
+BTCK_API struct BtcK_TransactionOutput* BtcK_TransactionOutput_InitAt(
+  void* storage, int64_t amount,
+  struct BtcK_ScriptPubkey const* script_pubkey, struct BtcK_Error** err);
+
+BTCK_API struct BtcK_TransactionOutput* BtcK_TransactionOutput_CopyAt(
+  void* storage, struct BtcK_TransactionOutput const* self,
+  struct BtcK_Error** err);
+
+BTCK_API void
+BtcK_TransactionOutput_Destroy(struct BtcK_TransactionOutput* self);
+
+BTCK_API size_t BtcK_TransactionOutput_DynamicMemoryUsage(
+  struct BtcK_TransactionOutput const* self);
+
 BTCK_API int64_t
 BtcK_TransactionOutput_GetAmount(struct BtcK_TransactionOutput const* self);
 
@@ -150,38 +290,106 @@ BTCK_API struct BtcK_ScriptPubkey const* BtcK_TransactionOutput_GetScriptPubkey(
 BTCK_API int BtcK_TransactionOutput_ToString(
   struct BtcK_TransactionOutput const* self, char* buf, size_t len);
 
+BTCK_API int BtcK_TransactionOutput_Compress(
+  struct BtcK_TransactionOutput const* self, BtcK_WriteBytes write,
+  void* userdata);
+
+BTCK_API struct BtcK_TransactionOutput* BtcK_TransactionOutput_Decompress(
+  void const* raw, size_t len, struct BtcK_Error** err);
+
+BTCK_API int BtcK_TransactionOutput_CompressMany(
+  struct BtcK_TransactionOutput const* const* outputs, size_t outputs_len,
+  BtcK_WriteBytes write, void* userdata);
+
+BTCK_API size_t BtcK_TransactionOutput_DecompressMany(
+  void const* raw, size_t len, struct BtcK_TransactionOutput** outputs,
+  size_t outputs_len, size_t* consumed, struct BtcK_Error** err);
+
 /*****************************************************************************/
 
 BTCK_API struct BtcK_Transaction* BtcK_Transaction_New(
   void const* raw, size_t len, struct BtcK_Error** err);
 
+BTCK_API struct BtcK_Transaction* BtcK_Transaction_NewIn(
+  struct BtcK_Arena* arena, void const* raw, size_t len,
+  struct BtcK_Error** err);
+
 BTCK_API struct BtcK_Transaction* BtcK_Transaction_Copy(
   struct BtcK_Transaction const* self, struct BtcK_Error** err);
 
+BTCK_API struct BtcK_Transaction* BtcK_Transaction_CopyIn(
+  struct BtcK_Arena* arena, struct BtcK_Transaction const* self,
+  struct BtcK_Error** err);
+
 BTCK_API void BtcK_Transaction_Free(struct BtcK_Transaction* self);
 
+BTCK_API size_t BtcK_Transaction_SizeOf(void);
+
+BTCK_API size_t BtcK_Transaction_AlignOf(void);
+
+BTCK_API struct BtcK_Transaction* BtcK_Transaction_InitAt(
+  void* storage, void const* raw, size_t len, struct BtcK_Error** err);
+
+BTCK_API struct BtcK_Transaction* BtcK_Transaction_CopyAt(
+  void* storage, struct BtcK_Transaction const* self, struct BtcK_Error** err);
+
+BTCK_API void BtcK_Transaction_Destroy(struct BtcK_Transaction* self);
+
+BTCK_API size_t
+BtcK_Transaction_DynamicMemoryUsage(struct BtcK_Transaction const* self);
+
 BTCK_API size_t
 BtcK_Transaction_CountOutputs(struct BtcK_Transaction const* self);
 
 BTCK_API struct BtcK_TransactionOutput const* BtcK_Transaction_GetOutput(
   struct BtcK_Transaction const* self, size_t idx);
 
+BTCK_API struct BtcK_TransactionOutput* BtcK_Transaction_GetOutputRef(
+  struct BtcK_Transaction const* self, size_t idx, struct BtcK_Error** err);
+
 BTCK_API int BtcK_Transaction_ToBytes(
   struct BtcK_Transaction const* self, BtcK_WriteBytes write, void* userdata);
 
 BTCK_API int BtcK_Transaction_ToString(
   struct BtcK_Transaction const* self, char* buf, size_t len);
 
+BTCK_API int BtcK_Transaction_ToJson(
+  struct BtcK_Transaction const* self, BtcK_WriteBytes write, void* userdata,
+  BtcK_JsonOptions options);
+
 /*****************************************************************************/
 
 BTCK_API struct BtcK_Block* BtcK_Block_New(
   void const* raw, size_t len, struct BtcK_Error** err);
 
+BTCK_API struct BtcK_Block* BtcK_Block_NewIn(
+  struct BtcK_Arena* arena, void const* raw, size_t len,
+  struct BtcK_Error** err);
+
 BTCK_API struct BtcK_Block* BtcK_Block_Copy(
   struct BtcK_Block const* self, struct BtcK_Error** err);
 
+BTCK_API struct BtcK_Block* BtcK_Block_CopyIn(
+  struct BtcK_Arena* arena, struct BtcK_Block const* self,
+  struct BtcK_Error** err);
+
 BTCK_API void BtcK_Block_Free(struct BtcK_Block* self);
 
+BTCK_API size_t BtcK_Block_SizeOf(void);
+
+BTCK_API size_t BtcK_Block_AlignOf(void);
+
+BTCK_API struct BtcK_Block* BtcK_Block_InitAt(
+  void* storage, void const* raw, size_t len, struct BtcK_Error** err);
+
+BTCK_API struct BtcK_Block* BtcK_Block_CopyAt(
+  void* storage, struct BtcK_Block const* self, struct BtcK_Error** err);
+
+BTCK_API void BtcK_Block_Destroy(struct BtcK_Block* self);
+
+BTCK_API size_t
+BtcK_Block_DynamicMemoryUsage(struct BtcK_Block const* self);
+
 BTCK_API void BtcK_Block_GetHash(
   struct BtcK_Block const* self, struct BtcK_BlockHash* out);
 
@@ -190,12 +398,158 @@ BTCK_API size_t BtcK_Block_CountTransactions(struct BtcK_Block const* self);
 BTCK_API struct BtcK_Transaction const* BtcK_Block_GetTransaction(
   struct BtcK_Block const* self, size_t idx);
 
+BTCK_API struct BtcK_Transaction* BtcK_Block_GetTransactionRef(
+  struct BtcK_Block const* self, size_t idx, struct BtcK_Error** err);
+
 BTCK_API int BtcK_Block_ToBytes(
   struct BtcK_Block const* self, BtcK_WriteBytes write, void* userdata);
 
 BTCK_API int BtcK_Block_ToString(
   struct BtcK_Block const* self, char* buf, size_t len);
 
+// Arrays sized by num_outputs hold one entry per output. script_offsets
+// holds num_outputs + 1 entries, its capacity is script_offsets_len.
+struct BtcK_BlockColumns {
+  size_t num_outputs;
+  size_t script_offsets_len;
+  size_t script_data_len;
+  int64_t* amounts;
+  uint32_t* script_offsets;
+  uint8_t* script_data;
+  uint32_t* tx_index;
+  uint32_t* output_index;
+};
+
+BTCK_API int BtcK_Block_ExportColumns(
+  struct BtcK_Block const* self, struct BtcK_BlockColumns* columns);
+
+BTCK_API int BtcK_Block_ToJson(
+  struct BtcK_Block const* self, BtcK_WriteBytes write, void* userdata,
+  BtcK_JsonOptions options);
+
+BTCK_API int BtcK_Block_ExportMany(
+  struct BtcK_Block const* const* blocks, size_t blocks_len,
+  BtcK_ExportFormat format, BtcK_JsonOptions options, size_t num_threads,
+  BtcK_ExportSink sink, void* userdata, struct BtcK_Error** err);
+
+/*****************************************************************************/
+
+BTCK_API void BtcK_BlockUndo_Free(struct BtcK_BlockUndo* self);
+
+BTCK_API size_t
+BtcK_BlockUndo_CountTransactions(struct BtcK_BlockUndo const* self);
+
+BTCK_API size_t BtcK_BlockUndo_CountSpentOutputs(
+  struct BtcK_BlockUndo const* self, size_t tx_idx);
+
+BTCK_API struct BtcK_TransactionOutput const* const*
+BtcK_BlockUndo_GetSpentOutputs(
+  struct BtcK_BlockUndo const* self, size_t tx_idx);
+
+BTCK_API uint32_t BtcK_BlockUndo_GetSpentOutputHeight(
+  struct BtcK_BlockUndo const* self, size_t tx_idx, size_t input_idx);
+
+BTCK_API int BtcK_BlockUndo_IsSpentOutputCoinbase(
+  struct BtcK_BlockUndo const* self, size_t tx_idx, size_t input_idx);
+
+BTCK_API int BtcK_Block_VerifyScripts(
+  struct BtcK_Block const* block, struct BtcK_BlockUndo const* undo,
+  BtcK_VerificationFlags flags, struct BtcK_Error** err);
+
+/*****************************************************************************/
+
+// A block decoded into a single buffer, with every field kept, witnesses
+// included. It has its own accessors rather than sitting behind the BtcK_Block
+// ones, because those lend out transaction and output objects that the flat
+// layout does not contain. BtcK_FlatBlock_FromBlock and BtcK_FlatBlock_ToBlock
+// convert where the BtcK_Block accessors are needed.
+BTCK_API struct BtcK_FlatBlock* BtcK_FlatBlock_New(
+  void const* raw, size_t len, struct BtcK_Error** err);
+
+BTCK_API struct BtcK_FlatBlock* BtcK_FlatBlock_FromBlock(
+  struct BtcK_Block const* block, struct BtcK_Error** err);
+
+BTCK_API struct BtcK_Block* BtcK_FlatBlock_ToBlock(
+  struct BtcK_FlatBlock const* self, struct BtcK_Error** err);
+
+BTCK_API struct BtcK_FlatBlock* BtcK_FlatBlock_Copy(
+  struct BtcK_FlatBlock const* self, struct BtcK_Error** err);
+
+BTCK_API void BtcK_FlatBlock_Free(struct BtcK_FlatBlock* self);
+
+BTCK_API size_t
+BtcK_FlatBlock_DynamicMemoryUsage(struct BtcK_FlatBlock const* self);
+
+BTCK_API void BtcK_FlatBlock_GetHash(
+  struct BtcK_FlatBlock const* self, struct BtcK_BlockHash* out);
+
+BTCK_API size_t
+BtcK_FlatBlock_CountTransactions(struct BtcK_FlatBlock const* self);
+
+BTCK_API size_t BtcK_FlatBlock_CountInputs(struct BtcK_FlatBlock const* self);
+
+BTCK_API size_t BtcK_FlatBlock_CountOutputs(struct BtcK_FlatBlock const* self);
+
+BTCK_API uint32_t BtcK_FlatBlock_GetTransactionVersion(
+  struct BtcK_FlatBlock const* self, size_t tx_idx);
+
+BTCK_API uint32_t BtcK_FlatBlock_GetTransactionLockTime(
+  struct BtcK_FlatBlock const* self, size_t tx_idx);
+
+BTCK_API size_t
+BtcK_FlatBlock_GetFirstInput(struct BtcK_FlatBlock const* self, size_t tx_idx);
+
+BTCK_API size_t
+BtcK_FlatBlock_GetFirstOutput(struct BtcK_FlatBlock const* self, size_t tx_idx);
+
+BTCK_API void BtcK_FlatBlock_GetInputPrevout(
+  struct BtcK_FlatBlock const* self, size_t idx, unsigned char* txid,
+  uint32_t* vout);
+
+BTCK_API uint32_t
+BtcK_FlatBlock_GetInputSequence(struct BtcK_FlatBlock const* self, size_t idx);
+
+BTCK_API uint8_t const* BtcK_FlatBlock_GetInputScriptSig(
+  struct BtcK_FlatBlock const* self, size_t idx, size_t* len);
+
+BTCK_API size_t BtcK_FlatBlock_CountInputWitnessItems(
+  struct BtcK_FlatBlock const* self, size_t idx);
+
+BTCK_API uint8_t const* BtcK_FlatBlock_GetInputWitnessItem(
+  struct BtcK_FlatBlock const* self, size_t idx, size_t item_idx, size_t* len);
+
+BTCK_API int64_t
+BtcK_FlatBlock_GetOutputAmount(struct BtcK_FlatBlock const* self, size_t idx);
+
+BTCK_API uint8_t const* BtcK_FlatBlock_GetOutputScriptPubkey(
+  struct BtcK_FlatBlock const* self, size_t idx, size_t* len);
+
+/*****************************************************************************/
+
+BTCK_API struct BtcK_ArchiveWriter* BtcK_ArchiveWriter_New(
+  BtcK_WriteBytes write, void* userdata, size_t segment_bytes,
+  struct BtcK_Error** err);
+
+BTCK_API void BtcK_ArchiveWriter_Free(struct BtcK_ArchiveWriter* self);
+
+BTCK_API int BtcK_ArchiveWriter_Append(
+  struct BtcK_ArchiveWriter* self, struct BtcK_Block const* block,
+  struct BtcK_Error** err);
+
+BTCK_API int BtcK_ArchiveWriter_Finish(
+  struct BtcK_ArchiveWriter* self, struct BtcK_Error** err);
+
+BTCK_API struct BtcK_ArchiveReader* BtcK_ArchiveReader_New(
+  void const* data, size_t len, struct BtcK_Error** err);
+
+BTCK_API void BtcK_ArchiveReader_Free(struct BtcK_ArchiveReader* self);
+
+BTCK_API size_t
+BtcK_ArchiveReader_CountBlocks(struct BtcK_ArchiveReader const* self);
+
+BTCK_API struct BtcK_Block* BtcK_ArchiveReader_GetBlock(
+  struct BtcK_ArchiveReader const* self, size_t idx, struct BtcK_Error** err);
+
 /*****************************************************************************/
 
 // enum class ValidationState
@@ -235,11 +589,11 @@ BTCK_API int BtcK_Block_ToString(
 // public delegate double AnalyzeFunc (int a, int b);
 
 typedef uint8_t BtcK_ChainType;
-#define BtcK_ChainType_MAINNET (BtcK_ChainType(0))
-#define BtcK_ChainType_TESTNET (BtcK_ChainType(1))
-#define BtcK_ChainType_TESTNET_4 (BtcK_ChainType(2))
-#define BtcK_ChainType_SIGNET (BtcK_ChainType(3))
-#define BtcK_ChainType_REGTEST (BtcK_ChainType(4))
+#define BtcK_ChainType_MAINNET ((BtcK_ChainType)(0))
+#define BtcK_ChainType_TESTNET ((BtcK_ChainType)(1))
+#define BtcK_ChainType_TESTNET_4 ((BtcK_ChainType)(2))
+#define BtcK_ChainType_SIGNET ((BtcK_ChainType)(3))
+#define BtcK_ChainType_REGTEST ((BtcK_ChainType)(4))
 
 // using Log = std::function<void(std::string_view)>;
 
@@ -288,8 +642,67 @@ typedef uint8_t BtcK_ChainType;
 //     auto SetChainstateDbInMemory(bool chainstate_db_in_memory) && -> KwArgs;
 //   };
 
-//   Chain(std::string_view data_dir, std::string_view blocks_dir, KwArgs kwargs = {});
-// BTCK_API BtcK_Chain* BtcK_Chain_New();
+struct BtcK_ChainOptions {
+  BtcK_ChainType chain_type;
+  char const* data_dir;
+  char const* blocks_dir;
+  size_t cache_bytes;
+  size_t block_cache_bytes;
+  size_t max_open_block_files;
+  int worker_threads;
+  int block_tree_db_in_memory;
+  int chainstate_db_in_memory;
+  int wipe_block_tree_db;
+  int wipe_chainstate_db;
+  // Non-zero writes the block files without obfuscation, which lets
+  // BtcK_RawBlock_New map them instead of copying. The block manager only
+  // picks a key for an empty blocks directory, so this has no effect on
+  // existing block files, and fails if they already have a key.
+  int disable_block_file_obfuscation;
+};
+
+struct BtcK_BlockHeader {
+  int32_t version;
+  struct BtcK_BlockHash prev_hash;
+  unsigned char merkle_root[32];
+  uint32_t time;
+  uint32_t bits;
+  uint32_t nonce;
+};
+
+typedef uint32_t BtcK_BlockStatus;
+
+#define BtcK_BlockStatus_VALID_TREE ((BtcK_BlockStatus)(2))
+#define BtcK_BlockStatus_VALID_TRANSACTIONS ((BtcK_BlockStatus)(3))
+#define BtcK_BlockStatus_VALID_CHAIN ((BtcK_BlockStatus)(4))
+#define BtcK_BlockStatus_VALID_SCRIPTS ((BtcK_BlockStatus)(5))
+#define BtcK_BlockStatus_VALID_MASK ((BtcK_BlockStatus)(7))
+#define BtcK_BlockStatus_HAVE_DATA ((BtcK_BlockStatus)(1U << 3))
+#define BtcK_BlockStatus_HAVE_UNDO ((BtcK_BlockStatus)(1U << 4))
+#define BtcK_BlockStatus_FAILED_VALID ((BtcK_BlockStatus)(1U << 5))
+#define BtcK_BlockStatus_FAILED_CHILD ((BtcK_BlockStatus)(1U << 6))
+
+struct BtcK_BlockIndexEntry {
+  int32_t height;
+  struct BtcK_BlockHash hash;
+  struct BtcK_BlockHash prev_hash;
+  uint32_t time;
+  int64_t median_time_past;
+  // Little endian, like the bytes of a block hash.
+  unsigned char chain_work[32];
+  uint32_t num_transactions;
+  BtcK_BlockStatus status;
+};
+
+struct BtcK_BlockCacheStats {
+  uint64_t hits;
+  uint64_t misses;
+  size_t entries;
+  size_t bytes;
+};
+
+BTCK_API struct BtcK_Chain* BtcK_Chain_New(
+  struct BtcK_ChainOptions const* options, struct BtcK_Error** err);
 
 BTCK_API void BtcK_Chain_Free(struct BtcK_Chain* self);
 
@@ -298,8 +711,79 @@ BTCK_API struct BtcK_Block* BtcK_Chain_GetBlock(
   struct BtcK_Chain const* self, size_t idx, struct BtcK_Error** err);
 BTCK_API ptrdiff_t BtcK_Chain_FindBlock(
   struct BtcK_Chain const* self, struct BtcK_BlockHash const* block_hash);
+BTCK_API int BtcK_Chain_GetRawBlock(
+  struct BtcK_Chain const* self, size_t height, BtcK_WriteBytes write,
+  void* userdata, struct BtcK_Error** err);
+BTCK_API struct BtcK_BlockUndo* BtcK_Chain_GetBlockUndo(
+  struct BtcK_Chain const* self, size_t height, struct BtcK_Error** err);
+BTCK_API int BtcK_Chain_GetBlockHeader(
+  struct BtcK_Chain const* self, size_t height, struct BtcK_BlockHeader* out,
+  struct BtcK_Error** err);
+BTCK_API int BtcK_Chain_GetBlockIndexEntry(
+  struct BtcK_Chain const* self, size_t height,
+  struct BtcK_BlockIndexEntry* out, struct BtcK_Error** err);
+BTCK_API int BtcK_Chain_GetBlockIndexEntries(
+  struct BtcK_Chain const* self, size_t first, size_t last,
+  struct BtcK_BlockIndexEntry* out, struct BtcK_Error** err);
+BTCK_API void BtcK_Chain_GetBlockCacheStats(
+  struct BtcK_Chain const* self, struct BtcK_BlockCacheStats* out);
+
+BTCK_API int BtcK_Chain_ExportBlocks(
+  struct BtcK_Chain const* self, size_t first, size_t last,
+  BtcK_ExportFormat format, BtcK_JsonOptions options, size_t num_threads,
+  BtcK_ExportSink sink, void* userdata, struct BtcK_Error** err);
+
+typedef int (*BtcK_ScanMap)(
+  size_t shard, size_t height, struct BtcK_Block const* block, void* userdata);
+typedef int (*BtcK_ScanReduce)(size_t shard, void* userdata);
+
+BTCK_API int BtcK_Chain_ParallelScan(
+  struct BtcK_Chain const* self, size_t first, size_t last, size_t shard_size,
+  size_t num_threads, BtcK_ScanMap map, BtcK_ScanReduce reduce,
+  void* userdata, struct BtcK_Error** err);
+
+typedef int (*BtcK_ImportProgress)(
+  size_t blocks_done, size_t blocks_total, void* userdata);
+
+// Blocks in blk?????.dat files of the chain's blocks directory that the
+// chain has not written to yet are indexed where they are. Blocks from
+// anywhere else are copied into the chain's block files. `blocks_skipped`
+// may be null.
+BTCK_API int BtcK_Chain_ImportBlocks(
+  struct BtcK_Chain* self, char const* const* paths, size_t num_paths,
+  size_t num_threads, BtcK_ImportProgress progress, void* userdata,
+  size_t* blocks_skipped, struct BtcK_Error** err);
+
+BTCK_API struct BtcK_RawBlock* BtcK_RawBlock_New(
+  struct BtcK_Chain const* chain, size_t height, struct BtcK_Error** err);
+BTCK_API void BtcK_RawBlock_Free(struct BtcK_RawBlock* self);
+BTCK_API void const* BtcK_RawBlock_GetBytes(
+  struct BtcK_RawBlock const* self, size_t* len);
+BTCK_API int BtcK_RawBlock_IsMapped(struct BtcK_RawBlock const* self);
+
+BTCK_API struct BtcK_ChainCursor* BtcK_ChainCursor_New(
+  struct BtcK_Chain const* chain, size_t first, size_t last,
+  size_t queue_depth, size_t max_bytes, size_t num_threads,
+  struct BtcK_Error** err);
+BTCK_API void BtcK_ChainCursor_Free(struct BtcK_ChainCursor* self);
+BTCK_API struct BtcK_Block* BtcK_ChainCursor_Next(
+  struct BtcK_ChainCursor* self, struct BtcK_Error** err);
+
+BTCK_API struct BtcK_ChainSnapshot* BtcK_ChainSnapshot_New(
+  struct BtcK_Chain const* chain, struct BtcK_Error** err);
+BTCK_API void BtcK_ChainSnapshot_Free(struct BtcK_ChainSnapshot* self);
+BTCK_API size_t
+BtcK_ChainSnapshot_CountBlocks(struct BtcK_ChainSnapshot const* self);
+BTCK_API struct BtcK_Block* BtcK_ChainSnapshot_GetBlock(
+  struct BtcK_ChainSnapshot const* self, size_t height,
+  struct BtcK_Error** err);
+BTCK_API int BtcK_ChainSnapshot_GetBlockHash(
+  struct BtcK_ChainSnapshot const* self, size_t height,
+  struct BtcK_BlockHash* out, struct BtcK_Error** err);
+BTCK_API ptrdiff_t BtcK_ChainSnapshot_FindBlock(
+  struct BtcK_ChainSnapshot const* self,
+  struct BtcK_BlockHash const* block_hash);
 
-//   bool ImportBlocks(std::span<std::string const> const paths) const;
 //   bool ProcessBlock(Block const& block, bool* new_block) const;
 
 #ifdef __cplusplus
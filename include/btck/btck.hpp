@@ -13,6 +13,7 @@
 #include <functional>
 #include <iterator>
 #include <memory>
+#include <optional>
 #include <span>
 #include <string>
 #include <string_view>
@@ -20,9 +21,16 @@
 #include <utility>
 #include <vector>
 
+struct BtcK_ArchiveReader;
+struct BtcK_ArchiveWriter;
+struct BtcK_Arena;
 struct BtcK_Block;
+struct BtcK_BlockUndo;
 struct BtcK_Chain;
+struct BtcK_ChainCursor;
 struct BtcK_Error;
+struct BtcK_FlatBlock;
+struct BtcK_RawBlock;
 struct BtcK_ScriptPubkey;
 struct BtcK_Transaction;
 struct BtcK_TransactionOutput;
@@ -252,6 +260,22 @@ template <typename T> struct unowned_policy {
   static void free(T const* /*p*/) {}
 };
 
+// Objects owned by an arena, which destroys them all at once.
+template <typename T> struct arena_policy {
+  using pointer = T const*;
+  using const_pointer = T const*;
+  static auto copy(T const* p) { return p; }
+  static void free(T const* /*p*/) {}
+};
+
+// Canonical instances from an intern table, shared by reference counting.
+template <typename T> struct interned_policy {
+  using pointer = T const*;
+  using const_pointer = T const*;
+  static auto copy(T const* p) { return c_api_traits<T>::intern(p); }
+  static void free(T const* p) { c_api_traits<T>::release(p); }
+};
+
 struct internal_t {};
 constexpr auto const internal = internal_t{};
 
@@ -313,6 +337,14 @@ template <template <typename> typename Api>
 auto make_unowned(wrapper<Api, owned_policy> const& arg)
   -> wrapper<Api, unowned_policy>;
 
+template <template <typename> typename Api>
+auto make_in_arena(wrapper<Api, owned_policy> const& arg)
+  -> wrapper<Api, arena_policy>;
+
+template <template <typename> typename Api>
+auto make_interned(wrapper<Api, owned_policy> const& arg)
+  -> wrapper<Api, interned_policy>;
+
 struct get_impl_ {
   template <template <class> class Api, template <class> class Owned>
   auto operator()(wrapper<Api, Owned>& arg) const
@@ -342,6 +374,12 @@ namespace btck {
 template <typename T>
 using unowned = decltype(detail::make_unowned(std::declval<T>()));
 
+template <typename T>
+using in_arena = decltype(detail::make_in_arena(std::declval<T>()));
+
+template <typename T>
+using interned = decltype(detail::make_interned(std::declval<T>()));
+
 }  // namespace btck
 
 /******************************************************************************/
@@ -355,6 +393,11 @@ auto to_bytes_(void const* obj, to_bytes_fn writefn) -> std::vector<std::byte>;
 using to_string_fn = int (*)(void const*, char*, size_t);
 auto to_string_(void const* obj, to_string_fn printfn) -> std::string;
 
+using to_json_fn =
+  int (*)(void const*, BtcK_WriteBytes, void*, BtcK_JsonOptions);
+auto to_json_(void const* obj, to_json_fn writefn, BtcK_JsonOptions options)
+  -> std::string;
+
 template <typename T>
 auto to_bytes(T const* obj, int (*writefn)(T const*, BtcK_WriteBytes, void*))
 {
@@ -370,6 +413,17 @@ auto to_string(T const* obj, int (*printfn)(T const*, char*, size_t))
     reinterpret_cast<to_string_fn>(printfn));
 }
 
+template <typename T>
+auto to_json(
+  T const* obj,
+  int (*writefn)(T const*, BtcK_WriteBytes, void*, BtcK_JsonOptions),
+  BtcK_JsonOptions options)
+{
+  return to_json_(
+    reinterpret_cast<void const*>(obj), reinterpret_cast<to_json_fn>(writefn),
+    options);
+}
+
 }  // namespace btck::detail
 
 /******************************************************************************/
@@ -485,6 +539,54 @@ inline auto to_string(verification_flags flags)
 template <>
 struct btck::detail::is_flag_enum<btck::verification_flags> : std::true_type {};
 
+/******************************************************************************/
+// MARK: JsonOptions
+
+namespace btck {
+
+enum class json_options : BtcK_JsonOptions {
+  none = BtcK_JsonOptions_NONE,
+  verbose = BtcK_JsonOptions_VERBOSE,
+  decode_scripts = BtcK_JsonOptions_DECODE_SCRIPTS,
+  witness = BtcK_JsonOptions_WITNESS,
+  tx_hex = BtcK_JsonOptions_TX_HEX,
+  all = BtcK_JsonOptions_ALL,
+};
+
+}  // namespace btck
+
+template <>
+struct btck::detail::is_flag_enum<btck::json_options> : std::true_type {};
+
+/******************************************************************************/
+// MARK: MemoryStats
+
+namespace btck {
+
+enum class object_type : BtcK_ObjectType {
+  script_pubkey = BtcK_ObjectType_SCRIPT_PUBKEY,
+  transaction_output = BtcK_ObjectType_TRANSACTION_OUTPUT,
+  transaction = BtcK_ObjectType_TRANSACTION,
+  block = BtcK_ObjectType_BLOCK,
+  flat_block = BtcK_ObjectType_FLAT_BLOCK,
+};
+
+using memory_stats = BtcK_MemoryStats;
+
+// Live objects of `type` and the memory they hold, if the library was built
+// with BTCK_ENABLE_MEMORY_STATS. Data that handles share, like a block and its
+// copies, is counted once, under the type of the handle that created it.
+inline auto get_memory_stats(object_type type) -> std::optional<memory_stats>
+{
+  auto stats = memory_stats{};
+  if (BtcK_GetMemoryStats(static_cast<BtcK_ObjectType>(type), &stats) != 0) {
+    return std::nullopt;
+  }
+  return stats;
+}
+
+}  // namespace btck
+
 /******************************************************************************/
 
 namespace btck::detail {
@@ -528,7 +630,22 @@ template <> struct btck::detail::c_api_traits<BtcK_ScriptPubkey> {
     return invoke(BtcK_ScriptPubkey_Copy, self);
   }
 
+  static auto copy_in(BtcK_Arena* arena, BtcK_ScriptPubkey const* self)
+  {
+    return invoke(BtcK_ScriptPubkey_CopyIn, arena, self);
+  }
+
   static void free(BtcK_ScriptPubkey* self) { BtcK_ScriptPubkey_Free(self); }
+
+  static auto intern(BtcK_ScriptPubkey const* self)
+  {
+    return invoke(BtcK_ScriptPubkey_Intern, self);
+  }
+
+  static void release(BtcK_ScriptPubkey const* self)
+  {
+    BtcK_ScriptPubkey_Release(self);
+  }
 };
 
 namespace btck {
@@ -549,6 +666,11 @@ public:
     verification_flags flags) const -> bool;
 
 private:
+  friend auto dynamic_memory_usage(script_pubkey_api const& self) -> std::size_t
+  {
+    return BtcK_ScriptPubkey_DynamicMemoryUsage(self.impl());
+  }
+
   friend auto to_bytes(script_pubkey_api const& self) -> std::vector<std::byte>
   {
     return detail::to_bytes(self.impl(), BtcK_ScriptPubkey_ToBytes);
@@ -571,6 +693,14 @@ auto operator==(
   return BtcK_ScriptPubkey_Equal(get_impl(left), get_impl(right)) != 0;
 }
 
+// Interned scripts are canonical, so equal contents mean the same address.
+inline auto operator==(
+  wrapper<script_pubkey_api, interned_policy> const& left,
+  wrapper<script_pubkey_api, interned_policy> const& right) -> bool
+{
+  return get_impl(left) == get_impl(right);
+}
+
 }  // namespace detail
 
 class script_pubkey
@@ -597,6 +727,11 @@ template <> struct btck::detail::c_api_traits<BtcK_TransactionOutput> {
     return invoke(BtcK_TransactionOutput_Copy, self);
   }
 
+  static auto copy_in(BtcK_Arena* arena, BtcK_TransactionOutput const* self)
+  {
+    return invoke(BtcK_TransactionOutput_CopyIn, arena, self);
+  }
+
   static void free(BtcK_TransactionOutput* self)
   {
     BtcK_TransactionOutput_Free(self);
@@ -623,11 +758,23 @@ public:
   }
 
 private:
+  friend auto dynamic_memory_usage(transaction_output_api const& self)
+    -> std::size_t
+  {
+    return BtcK_TransactionOutput_DynamicMemoryUsage(self.impl());
+  }
+
   friend auto to_string(transaction_output_api const& self)
   {
     return detail::to_string(self.impl(), BtcK_TransactionOutput_ToString);
   }
 
+  friend auto compress(transaction_output_api const& self)
+    -> std::vector<std::byte>
+  {
+    return detail::to_bytes(self.impl(), BtcK_TransactionOutput_Compress);
+  }
+
   [[nodiscard]] auto impl() const
   {
     return static_cast<Derived const*>(this)->get();
@@ -645,12 +792,24 @@ class transaction_output
 public:
   using base::base;
 
-  transaction_output(std::int64_t amount, btck::script_pubkey const& sp)
+  // An interned script is held by reference rather than copied.
+  template <template <typename> typename Owned>
+  transaction_output(
+    std::int64_t amount,
+    detail::wrapper<detail::script_pubkey_api, Owned> const& sp)
     : base{
         detail::internal,
         detail::invoke(
           BtcK_TransactionOutput_New, amount, detail::get_impl(sp))}
   {}
+
+  static auto decompress(std::span<std::byte const> raw) -> transaction_output
+  {
+    return {
+      detail::internal,
+      detail::invoke(BtcK_TransactionOutput_Decompress, raw.data(), raw.size()),
+    };
+  }
 };
 
 }  // namespace btck
@@ -664,6 +823,11 @@ template <> struct btck::detail::c_api_traits<BtcK_Transaction> {
     return invoke(BtcK_Transaction_Copy, self);
   }
 
+  static auto copy_in(BtcK_Arena* arena, BtcK_Transaction const* self)
+  {
+    return invoke(BtcK_Transaction_CopyIn, arena, self);
+  }
+
   static void free(BtcK_Transaction* self) { BtcK_Transaction_Free(self); }
 };
 
@@ -691,6 +855,15 @@ public:
     };
   }
 
+  // An owned output that shares its script with the transaction.
+  [[nodiscard]] auto share(std::size_t idx) const -> transaction_output
+  {
+    return {
+      detail::internal,
+      detail::invoke(BtcK_Transaction_GetOutputRef, this->impl(), idx),
+    };
+  }
+
 private:
   [[nodiscard]] auto impl() const
   {
@@ -713,6 +886,11 @@ public:
   }
 
 private:
+  friend auto dynamic_memory_usage(transaction_api const& self) -> std::size_t
+  {
+    return BtcK_Transaction_DynamicMemoryUsage(self.impl());
+  }
+
   friend auto to_bytes(transaction_api const& self) -> std::vector<std::byte>
   {
     return detail::to_bytes(self.impl(), BtcK_Transaction_ToBytes);
@@ -723,6 +901,14 @@ private:
     return detail::to_string(self.impl(), BtcK_Transaction_ToString);
   }
 
+  friend auto to_json(
+    transaction_api const& self, json_options options = json_options::none)
+  {
+    return detail::to_json(
+      self.impl(), BtcK_Transaction_ToJson,
+      static_cast<BtcK_JsonOptions>(options));
+  }
+
   [[nodiscard]] auto impl() const
   {
     return static_cast<Derived const*>(this)->get();
@@ -792,6 +978,11 @@ template <> struct btck::detail::c_api_traits<BtcK_Block> {
     return invoke(BtcK_Block_Copy, self);
   }
 
+  static auto copy_in(BtcK_Arena* arena, BtcK_Block const* self)
+  {
+    return invoke(BtcK_Block_CopyIn, arena, self);
+  }
+
   static void free(BtcK_Block* self) { BtcK_Block_Free(self); }
 };
 
@@ -819,6 +1010,15 @@ public:
     };
   }
 
+  // An owned transaction that shares its data with the block.
+  [[nodiscard]] auto share(std::size_t idx) const -> transaction
+  {
+    return {
+      detail::internal,
+      detail::invoke(BtcK_Block_GetTransactionRef, this->impl(), idx),
+    };
+  }
+
 private:
   [[nodiscard]] auto impl() const
   {
@@ -834,6 +1034,15 @@ template <typename Derived> class block_api
 public:
   using c_type = BtcK_Block;
 
+  // One row per transaction output, laid out like an Arrow record batch.
+  struct columns {
+    std::vector<std::int64_t> amounts;
+    std::vector<std::uint32_t> script_offsets;
+    std::vector<std::byte> script_data;
+    std::vector<std::uint32_t> tx_index;
+    std::vector<std::uint32_t> output_index;
+  };
+
   [[nodiscard]] auto hash() const -> BlockHash
   {
     auto hash = BlockHash{};
@@ -848,6 +1057,11 @@ public:
   }
 
 private:
+  friend auto dynamic_memory_usage(block_api const& self) -> std::size_t
+  {
+    return BtcK_Block_DynamicMemoryUsage(self.impl());
+  }
+
   friend auto to_bytes(block_api const& self) -> std::vector<std::byte>
   {
     return detail::to_bytes(self.impl(), BtcK_Block_ToBytes);
@@ -858,6 +1072,41 @@ private:
     return detail::to_string(self.impl(), BtcK_Block_ToString);
   }
 
+  friend auto to_json(
+    block_api const& self, json_options options = json_options::none)
+  {
+    return detail::to_json(
+      self.impl(), BtcK_Block_ToJson, static_cast<BtcK_JsonOptions>(options));
+  }
+
+  friend auto export_columns(block_api const& self) -> columns
+  {
+    auto sizes = BtcK_BlockColumns{};
+    BtcK_Block_ExportColumns(self.impl(), &sizes);
+
+    auto result = columns{};
+    result.amounts.resize(sizes.num_outputs);
+    result.script_offsets.resize(sizes.script_offsets_len);
+    result.script_data.resize(sizes.script_data_len);
+    result.tx_index.resize(sizes.num_outputs);
+    result.output_index.resize(sizes.num_outputs);
+
+    auto out = BtcK_BlockColumns{
+      .num_outputs = sizes.num_outputs,
+      .script_offsets_len = sizes.script_offsets_len,
+      .script_data_len = sizes.script_data_len,
+      .amounts = result.amounts.data(),
+      .script_offsets = result.script_offsets.data(),
+      .script_data = reinterpret_cast<std::uint8_t*>(result.script_data.data()),
+      .tx_index = result.tx_index.data(),
+      .output_index = result.output_index.data(),
+    };
+    [[maybe_unused]] int const ret =
+      BtcK_Block_ExportColumns(self.impl(), &out);
+    assert(ret == 0);
+    return result;
+  }
+
   [[nodiscard]] auto impl() const
   {
     return static_cast<Derived const*>(this)->get();
@@ -882,6 +1131,221 @@ public:
   {}
 };
 
+}  // namespace btck
+
+/******************************************************************************/
+// MARK: BlockUndo
+
+namespace btck {
+
+// The outputs spent by a block, indexed by transaction as in the block. The
+// coinbase transaction at index 0 spends nothing.
+class block_undo
+{
+public:
+  class spent_outputs_view : public detail::range<spent_outputs_view const>
+  {
+  public:
+    using value_type = unowned<transaction_output>;
+
+    [[nodiscard]] auto size() const -> std::size_t
+    {
+      return BtcK_BlockUndo_CountSpentOutputs(undo_, tx_idx_);
+    }
+
+    [[nodiscard]] auto operator[](std::size_t idx) const -> value_type
+    {
+      return {
+        detail::internal,
+        BtcK_BlockUndo_GetSpentOutputs(undo_, tx_idx_)[idx],
+      };
+    }
+
+    [[nodiscard]] auto height(std::size_t idx) const -> std::uint32_t
+    {
+      return BtcK_BlockUndo_GetSpentOutputHeight(undo_, tx_idx_, idx);
+    }
+
+    [[nodiscard]] auto is_coinbase(std::size_t idx) const -> bool
+    {
+      return BtcK_BlockUndo_IsSpentOutputCoinbase(undo_, tx_idx_, idx) != 0;
+    }
+
+  private:
+    friend block_undo;
+    spent_outputs_view(BtcK_BlockUndo const* undo, std::size_t tx_idx)
+      : undo_{undo}
+      , tx_idx_{tx_idx}
+    {}
+
+    BtcK_BlockUndo const* undo_;
+    std::size_t tx_idx_;
+  };
+
+  [[nodiscard]] auto count_transactions() const -> std::size_t
+  {
+    return BtcK_BlockUndo_CountTransactions(impl_.get());
+  }
+
+  [[nodiscard]] auto spent_outputs(std::size_t tx_idx) const
+    -> spent_outputs_view
+  {
+    return {impl_.get(), tx_idx};
+  }
+
+  // Verifies the scripts of all inputs of `block`, which must be the block
+  // this undo data belongs to.
+  [[nodiscard]] auto verify_scripts(
+    block const& block, verification_flags flags) const -> bool
+  {
+    int const result = detail::invoke(
+      BtcK_Block_VerifyScripts, block.get(), impl_.get(),
+      static_cast<BtcK_VerificationFlags>(flags));
+    return result != 0;
+  }
+
+private:
+  friend class Chain;
+  explicit block_undo(BtcK_BlockUndo* impl) : impl_{impl} {}
+
+  struct deleter {
+    void operator()(BtcK_BlockUndo* undo) const { BtcK_BlockUndo_Free(undo); }
+  };
+
+  std::unique_ptr<BtcK_BlockUndo, deleter> impl_;
+};
+
+}  // namespace btck
+
+/******************************************************************************/
+// MARK: FlatBlock
+
+template <> struct btck::detail::c_api_traits<BtcK_FlatBlock> {
+  static auto copy(BtcK_FlatBlock const* self)
+  {
+    return invoke(BtcK_FlatBlock_Copy, self);
+  }
+
+  static void free(BtcK_FlatBlock* self) { BtcK_FlatBlock_Free(self); }
+};
+
+namespace btck {
+namespace detail {
+
+template <typename Derived>
+class flat_block_outputs_api
+  : public range<flat_block_outputs_api<Derived> const>
+{
+public:
+  using c_type = BtcK_FlatBlock const;
+
+  struct value_type {
+    std::int64_t amount;
+    std::span<std::byte const> script_pubkey;
+  };
+
+  [[nodiscard]] auto size() const -> std::size_t
+  {
+    return BtcK_FlatBlock_CountOutputs(this->impl());
+  }
+
+  [[nodiscard]] auto operator[](std::size_t idx) const -> value_type
+  {
+    auto len = std::size_t{0};
+    auto const* script =
+      BtcK_FlatBlock_GetOutputScriptPubkey(this->impl(), idx, &len);
+    return {
+      .amount = BtcK_FlatBlock_GetOutputAmount(this->impl(), idx),
+      .script_pubkey = as_bytes(std::span{script, len}),
+    };
+  }
+
+private:
+  [[nodiscard]] auto impl() const
+  {
+    return static_cast<Derived const*>(this)->get();
+  }
+
+  friend Derived;
+  flat_block_outputs_api() = default;
+};
+
+template <typename Derived> class flat_block_api
+{
+public:
+  using c_type = BtcK_FlatBlock;
+
+  [[nodiscard]] auto hash() const -> BlockHash
+  {
+    auto hash = BlockHash{};
+    BtcK_FlatBlock_GetHash(this->impl(), &hash.impl_);
+    return hash;
+  }
+
+  [[nodiscard]] auto count_transactions() const -> std::size_t
+  {
+    return BtcK_FlatBlock_CountTransactions(this->impl());
+  }
+
+  // Index of the first output of transaction `tx_idx` in outputs(). Passing
+  // count_transactions() yields the total number of outputs.
+  [[nodiscard]] auto first_output(std::size_t tx_idx) const -> std::size_t
+  {
+    return BtcK_FlatBlock_GetFirstOutput(this->impl(), tx_idx);
+  }
+
+  // All outputs of the block, in transaction order.
+  [[nodiscard]] auto outputs() const
+    -> detail::wrapper<flat_block_outputs_api, unowned_policy>
+  {
+    return {detail::internal, impl()};
+  }
+
+  // Rebuilds the block, witnesses included.
+  [[nodiscard]] auto to_block() const -> block
+  {
+    return {detail::internal, invoke(BtcK_FlatBlock_ToBlock, impl())};
+  }
+
+private:
+  friend auto dynamic_memory_usage(flat_block_api const& self) -> std::size_t
+  {
+    return BtcK_FlatBlock_DynamicMemoryUsage(self.impl());
+  }
+
+  [[nodiscard]] auto impl() const
+  {
+    return static_cast<Derived const*>(this)->get();
+  }
+
+  friend Derived;
+  flat_block_api() = default;
+};
+
+}  // namespace detail
+
+// A block decoded into a single contiguous allocation. Its outputs are stored
+// back to back, so walking them reads memory linearly.
+class flat_block
+  : public detail::wrapper<detail::flat_block_api, detail::owned_policy>
+{
+public:
+  using api_policy = flat_block_api;
+  using base::base;
+
+  flat_block(std::span<std::byte const> raw)
+    : base{
+        detail::internal,
+        detail::invoke(BtcK_FlatBlock_New, raw.data(), raw.size())}
+  {}
+
+  explicit flat_block(block const& block)
+    : base{
+        detail::internal,
+        detail::invoke(BtcK_FlatBlock_FromBlock, block.get())}
+  {}
+};
+
 enum class ValidationState : std::uint8_t {
   VALID,
   INVALID,
@@ -945,33 +1409,415 @@ public:
 
 }  // namespace btck
 
+/******************************************************************************/
+// MARK: Arena
+
+namespace btck {
+
+// Objects made by an arena stay valid until the arena is reset or destroyed.
+class arena
+{
+public:
+  arena()
+    : impl_{detail::invoke(BtcK_Arena_New)}
+  {}
+
+  void reset() { BtcK_Arena_Reset(impl_.get()); }
+
+  template <
+    template <typename> typename Api, template <typename> typename Owned>
+  [[nodiscard]] auto copy(detail::wrapper<Api, Owned> const& obj)
+    -> detail::wrapper<Api, detail::arena_policy>
+  {
+    using c_type = typename Api<detail::wrapper<Api, Owned>>::c_type;
+    return {
+      detail::internal,
+      detail::c_api_traits<c_type>::copy_in(
+        impl_.get(), detail::get_impl(obj)),
+    };
+  }
+
+  [[nodiscard]] auto make_script_pubkey(std::span<std::byte const> raw)
+    -> in_arena<script_pubkey>
+  {
+    return {
+      detail::internal,
+      detail::invoke(
+        BtcK_ScriptPubkey_NewIn, impl_.get(), raw.data(), raw.size()),
+    };
+  }
+
+  template <template <typename> typename Owned>
+  [[nodiscard]] auto make_transaction_output(
+    std::int64_t amount,
+    detail::wrapper<detail::script_pubkey_api, Owned> const& sp)
+    -> in_arena<transaction_output>
+  {
+    return {
+      detail::internal,
+      detail::invoke(
+        BtcK_TransactionOutput_NewIn, impl_.get(), amount,
+        detail::get_impl(sp)),
+    };
+  }
+
+  [[nodiscard]] auto make_transaction(std::span<std::byte const> raw)
+    -> in_arena<transaction>
+  {
+    return {
+      detail::internal,
+      detail::invoke(
+        BtcK_Transaction_NewIn, impl_.get(), raw.data(), raw.size()),
+    };
+  }
+
+  [[nodiscard]] auto make_block(std::span<std::byte const> raw)
+    -> in_arena<block>
+  {
+    return {
+      detail::internal,
+      detail::invoke(BtcK_Block_NewIn, impl_.get(), raw.data(), raw.size()),
+    };
+  }
+
+private:
+  struct deleter {
+    void operator()(BtcK_Arena* arena) const { BtcK_Arena_Free(arena); }
+  };
+
+  std::unique_ptr<BtcK_Arena, deleter> impl_;
+};
+
+}  // namespace btck
+
+/******************************************************************************/
+// MARK: Export
+
+namespace btck {
+
+enum class export_format : BtcK_ExportFormat {
+  bytes = BtcK_ExportFormat_BYTES,
+  json = BtcK_ExportFormat_JSON,
+};
+
+// Receives the serialized blocks in order, on the calling thread.
+using export_sink =
+  std::function<void(std::size_t, std::span<std::byte const>)>;
+
+void export_blocks(
+  std::span<block const> blocks, export_sink const& sink,
+  export_format format = export_format::bytes,
+  json_options options = json_options::none, std::size_t num_threads = 0);
+
+}  // namespace btck
+
+/******************************************************************************/
+// MARK: Archive
+
+namespace btck {
+
+class archive_writer
+{
+public:
+  using sink = std::function<void(std::span<std::byte const>)>;
+
+  // Starts a new segment with its own dictionaries once the scripts and
+  // pubkeys tracked for the current one take `segment_bytes`, 0 selects the
+  // default of 64 MiB.
+  explicit archive_writer(sink write, std::size_t segment_bytes = 0);
+
+  template <template <typename> typename Owned>
+  void append(detail::wrapper<detail::block_api, Owned> const& block)
+  {
+    append_(detail::get_impl(block));
+  }
+
+  void finish();
+
+private:
+  void append_(BtcK_Block const* block);
+
+  struct closure_t;
+  struct closure_deleter {
+    void operator()(closure_t* closure) const;
+  };
+
+  struct deleter {
+    void operator()(BtcK_ArchiveWriter* writer) const
+    {
+      BtcK_ArchiveWriter_Free(writer);
+    }
+  };
+
+  std::unique_ptr<closure_t, closure_deleter> closure_;
+  std::unique_ptr<BtcK_ArchiveWriter, deleter> impl_;
+};
+
+// Refers to `data`, which must outlive the reader.
+class archive_reader : public detail::range<archive_reader const>
+{
+public:
+  explicit archive_reader(std::span<std::byte const> data)
+    : impl_{detail::invoke(BtcK_ArchiveReader_New, data.data(), data.size())}
+  {}
+
+  using value_type = block;
+
+  [[nodiscard]] auto size() const -> std::size_t
+  {
+    return BtcK_ArchiveReader_CountBlocks(this->impl_.get());
+  }
+
+  [[nodiscard]] auto operator[](std::size_t idx) const -> value_type
+  {
+    return {
+      detail::internal,
+      detail::invoke(BtcK_ArchiveReader_GetBlock, this->impl_.get(), idx),
+    };
+  }
+
+private:
+  struct deleter {
+    void operator()(BtcK_ArchiveReader* reader) const
+    {
+      BtcK_ArchiveReader_Free(reader);
+    }
+  };
+
+  std::unique_ptr<BtcK_ArchiveReader, deleter> impl_;
+};
+
+}  // namespace btck
+
 /******************************************************************************/
 // MARK: Chain
 
 namespace btck {
 
+using block_header = BtcK_BlockHeader;
+using block_index_entry = BtcK_BlockIndexEntry;
+
+// The serialized bytes of a block as stored on disk. Unless the block files
+// are obfuscated, the bytes are mapped from the file without a copy. New
+// blocks directories are obfuscated unless the chain is created with
+// SetObfuscateBlockFiles(false).
+class raw_block
+{
+public:
+  [[nodiscard]] auto bytes() const -> std::span<std::byte const>
+  {
+    auto len = std::size_t{0};
+    auto const* data = BtcK_RawBlock_GetBytes(impl_.get(), &len);
+    return {static_cast<std::byte const*>(data), len};
+  }
+
+  [[nodiscard]] auto is_mapped() const -> bool
+  {
+    return BtcK_RawBlock_IsMapped(impl_.get()) != 0;
+  }
+
+private:
+  friend class Chain;
+  explicit raw_block(BtcK_RawBlock* impl) : impl_{impl} {}
+
+  struct deleter {
+    void operator()(BtcK_RawBlock* block) const { BtcK_RawBlock_Free(block); }
+  };
+
+  std::unique_ptr<BtcK_RawBlock, deleter> impl_;
+};
+
+// Called on worker threads, for the heights of one shard in order.
+using scan_map = std::function<void(
+  std::size_t shard, std::size_t height, unowned<block> const& block)>;
+
+// Called on the calling thread, once per shard in shard order.
+using scan_reduce = std::function<void(std::size_t shard)>;
+
+// Called on the calling thread after each batch of blocks was handed to
+// validation. Throwing cancels the import.
+using import_progress =
+  std::function<void(std::size_t blocks_done, std::size_t blocks_total)>;
+
+// Single pass over the blocks of a height range. Background threads read and
+// decode the blocks ahead of the one being processed. A cursor must not
+// outlive its chain.
+class chain_cursor
+{
+public:
+  class iterator
+  {
+  public:
+    using value_type = block;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() = default;
+
+    [[nodiscard]] auto operator*() const -> block const&
+    {
+      return *cursor_->current_;
+    }
+
+    [[nodiscard]] auto operator->() const -> block const*
+    {
+      return &*cursor_->current_;
+    }
+
+    auto operator++() -> iterator&
+    {
+      cursor_->advance();
+      return *this;
+    }
+
+    void operator++(int) { ++*this; }
+
+    friend auto operator==(iterator const& it, std::default_sentinel_t) -> bool
+    {
+      return it.at_end();
+    }
+
+  private:
+    friend chain_cursor;
+    explicit iterator(chain_cursor* cursor) : cursor_{cursor} {}
+
+    [[nodiscard]] auto at_end() const -> bool
+    {
+      return !cursor_->current_.has_value();
+    }
+
+    chain_cursor* cursor_ = nullptr;
+  };
+
+  [[nodiscard]] auto begin() -> iterator
+  {
+    if (!started_) {
+      started_ = true;
+      advance();
+    }
+    return iterator{this};
+  }
+
+  [[nodiscard]] auto end() const -> std::default_sentinel_t { return {}; }
+
+private:
+  friend class Chain;
+  explicit chain_cursor(BtcK_ChainCursor* impl) : impl_{impl} {}
+
+  void advance()
+  {
+    current_.reset();
+    if (auto* ptr = detail::invoke(BtcK_ChainCursor_Next, impl_.get())) {
+      current_.emplace(detail::internal, ptr);
+    }
+  }
+
+  struct deleter {
+    void operator()(BtcK_ChainCursor* cursor) const
+    {
+      BtcK_ChainCursor_Free(cursor);
+    }
+  };
+
+  std::unique_ptr<BtcK_ChainCursor, deleter> impl_;
+  std::optional<block> current_;
+  bool started_ = false;
+};
+
+// The active chain as of one tip change, unaffected by later ones. Unlike
+// Chain, whose size counts the blocks above genesis, the size of a snapshot
+// counts all of its blocks. A snapshot must not outlive its chain.
+class chain_snapshot : public detail::range<chain_snapshot const>
+{
+public:
+  using value_type = block;
+
+  [[nodiscard]] auto size() const -> std::size_t
+  {
+    return BtcK_ChainSnapshot_CountBlocks(this->impl_.get());
+  }
+
+  [[nodiscard]] auto operator[](std::size_t height) const -> value_type
+  {
+    return {
+      detail::internal,
+      detail::invoke(BtcK_ChainSnapshot_GetBlock, this->impl_.get(), height),
+    };
+  }
+
+  [[nodiscard]] auto hash(std::size_t height) const -> BlockHash
+  {
+    auto hash = BlockHash{};
+    detail::invoke(
+      BtcK_ChainSnapshot_GetBlockHash, this->impl_.get(), height,
+      &hash.impl_);
+    return hash;
+  }
+
+  [[nodiscard]] auto find(BlockHash const& block_hash) const -> iterator
+  {
+    std::ptrdiff_t const idx =
+      BtcK_ChainSnapshot_FindBlock(this->impl_.get(), &block_hash.impl_);
+    return (idx == -1) ? this->end() : this->begin() + idx;
+  }
+
+private:
+  friend class Chain;
+  explicit chain_snapshot(BtcK_ChainSnapshot* impl) : impl_{impl} {}
+
+  struct deleter {
+    void operator()(BtcK_ChainSnapshot* snapshot) const
+    {
+      BtcK_ChainSnapshot_Free(snapshot);
+    }
+  };
+
+  std::unique_ptr<BtcK_ChainSnapshot, deleter> impl_;
+};
+
 class Chain : public detail::range<Chain const>
 {
 public:
   // poor man's cpp support for named arguments
   struct KwArgs {
     KwArgs();
-    auto chain_type(chain_type arg) && -> KwArgs;
+    auto chain_type(btck::chain_type arg) && -> KwArgs;
     auto validation(Validation arg) && -> KwArgs;
 
     template <typename T>
     auto notifications(KernelNotifications<T> arg) && -> KwArgs;
 
+    // Size of the database caches in bytes, 0 selects the kernel default.
+    auto SetCacheSize(std::size_t cache_bytes) && -> KwArgs;
+    // Memory for recently read blocks, 0 disables the block cache.
+    auto SetBlockCacheSize(std::size_t block_cache_bytes) && -> KwArgs;
+    // Block files kept open for concurrent readers, 0 opens them per read.
+    auto SetMaxOpenBlockFiles(std::size_t max_open_block_files) && -> KwArgs;
     auto SetWorkerThreads(int worker_threads) && -> KwArgs;
     auto SetWipeDbs(bool wipe_block_tree, bool wipe_chainstate) && -> KwArgs;
     auto SetBlockTreeDbInMemory(bool block_tree_db_in_memory) && -> KwArgs;
     auto SetChainstateDbInMemory(bool chainstate_db_in_memory) && -> KwArgs;
+    // Unobfuscated block files let raw blocks be mapped, see raw_block.
+    auto SetObfuscateBlockFiles(bool obfuscate) && -> KwArgs;
+
+  private:
+    friend class Chain;
+    BtcK_ChainOptions options_;
   };
 
   Chain(
     std::string_view data_dir, std::string_view blocks_dir, KwArgs kwargs = {});
 
-  // auto ImportBlocks(std::span<std::string const> paths) -> bool;
+  // Reads the blocks from the given block files on background threads and
+  // connects them on the calling thread. Blocks may appear in any order.
+  // Returns the number of blocks that were skipped because they did not
+  // decode, were invalid or their parent was never found; already known
+  // blocks are not skipped. Readers of the chain keep working while the tip
+  // moves. Files the chain has not written to, in its blocks directory, are
+  // indexed in place instead of being copied.
+  auto import_blocks(
+    std::span<std::string const> paths, import_progress const& progress = {},
+    std::size_t num_threads = 0) -> std::size_t;
+
   // auto ProcessBlock(Block const& block, bool* new_block) -> bool;
 
   using value_type = block;
@@ -996,6 +1842,95 @@ public:
     return (idx == -1) ? this->end() : this->begin() + idx;
   }
 
+  // Repeatable reads across several calls, without waiting for validation.
+  [[nodiscard]] auto snapshot() const -> chain_snapshot
+  {
+    return chain_snapshot{
+      detail::invoke(BtcK_ChainSnapshot_New, this->impl_.get())};
+  }
+
+  [[nodiscard]] auto get_raw_block(std::size_t height) const -> raw_block
+  {
+    return raw_block{
+      detail::invoke(BtcK_RawBlock_New, this->impl_.get(), height)};
+  }
+
+  [[nodiscard]] auto get_block_undo(std::size_t height) const -> block_undo
+  {
+    return block_undo{
+      detail::invoke(BtcK_Chain_GetBlockUndo, this->impl_.get(), height)};
+  }
+
+  // Header and index data are kept in memory and never read from disk.
+  [[nodiscard]] auto get_block_header(std::size_t height) const -> block_header
+  {
+    auto header = block_header{};
+    detail::invoke(
+      BtcK_Chain_GetBlockHeader, this->impl_.get(), height, &header);
+    return header;
+  }
+
+  [[nodiscard]] auto get_block_index_entry(std::size_t height) const
+    -> block_index_entry
+  {
+    auto entry = block_index_entry{};
+    detail::invoke(
+      BtcK_Chain_GetBlockIndexEntry, this->impl_.get(), height, &entry);
+    return entry;
+  }
+
+  // Index entries of the blocks at heights [first, last).
+  [[nodiscard]] auto get_block_index_entries(
+    std::size_t first, std::size_t last) const
+    -> std::vector<block_index_entry>
+  {
+    auto const count = last > first ? last - first : 0;
+    auto entries = std::vector<block_index_entry>(count);
+    detail::invoke(
+      BtcK_Chain_GetBlockIndexEntries, this->impl_.get(), first, last,
+      entries.data());
+    return entries;
+  }
+
+  using block_cache_stats = BtcK_BlockCacheStats;
+
+  [[nodiscard]] auto get_block_cache_stats() const -> block_cache_stats
+  {
+    auto stats = block_cache_stats{};
+    BtcK_Chain_GetBlockCacheStats(this->impl_.get(), &stats);
+    return stats;
+  }
+
+  // Reads the blocks at heights [first, last) in order, up to `queue_depth`
+  // blocks or `max_bytes` of decoded blocks ahead of the caller. Blocks still
+  // being read count at the average size so far, so `max_bytes` is only
+  // approximate. Zero selects the defaults, which is no memory limit for
+  // `max_bytes`. The blocks bypass the block cache.
+  [[nodiscard]] auto read_ahead(
+    std::size_t first, std::size_t last, std::size_t queue_depth = 0,
+    std::size_t max_bytes = 0, std::size_t num_threads = 0) const
+    -> chain_cursor
+  {
+    return chain_cursor{detail::invoke(
+      BtcK_ChainCursor_New, this->impl_.get(), first, last, queue_depth,
+      max_bytes, num_threads)};
+  }
+
+  // Maps the blocks at heights [first, last) in parallel. Shard `n` covers the
+  // `shard_size` heights starting at `first + n * shard_size`. The first
+  // exception stops the scan and is rethrown.
+  void parallel_scan(
+    std::size_t first, std::size_t last, std::size_t shard_size,
+    scan_map const& map, scan_reduce const& reduce = {},
+    std::size_t num_threads = 0) const;
+
+  // Exports the blocks at heights [first, last).
+  void export_blocks(
+    std::size_t first, std::size_t last, export_sink const& sink,
+    export_format format = export_format::bytes,
+    json_options options = json_options::none,
+    std::size_t num_threads = 0) const;
+
 private:
   struct deleter {
     void operator()(BtcK_Chain* chain) const { BtcK_Chain_Free(chain); }
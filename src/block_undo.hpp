@@ -0,0 +1,31 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <btck/btck.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "undo.h"
+
+// The outputs spent by the transactions of a block, as stored in the undo
+// files. Transactions are indexed as in the block, so the coinbase at index 0
+// spends nothing.
+struct BtcK_BlockUndo {
+  explicit BtcK_BlockUndo(CBlockUndo undo);
+  BtcK_BlockUndo(BtcK_BlockUndo const&) = delete;
+  auto operator=(BtcK_BlockUndo const&) -> BtcK_BlockUndo& = delete;
+
+  [[nodiscard]] auto SpentCoin(std::size_t tx_idx, std::size_t input_idx) const
+    -> Coin const&;
+
+  CBlockUndo undo;
+
+  // Handles to the spent outputs of all inputs in block order, and the start
+  // of each transaction's run, plus one past the end.
+  std::vector<BtcK_TransactionOutput const*> spent_outputs;
+  std::vector<std::size_t> offsets;
+};
@@ -4,14 +4,78 @@
 
 #include <btck/btck.hpp>
 #include <btck/btck_error.hpp>
+#include <cstddef>
 #include <cstring>
 #include <exception>
+#include <mutex>
 #include <new>
+#include <span>
+#include <string>
+#include <string_view>
 #include <stdexcept>
 #include <system_error>
+#include <utility>
+#include <vector>
 
 namespace {
 
+struct export_closure_t {
+  btck::export_sink const* sink;
+  std::exception_ptr exception;
+};
+
+auto export_callback(std::size_t idx, void const* buf, size_t len, void* user)
+  -> int
+{
+  auto& closure = *reinterpret_cast<export_closure_t*>(user);
+  try {
+    (*closure.sink)(idx, std::span{static_cast<std::byte const*>(buf), len});
+    return 0;
+  }
+  catch (...) {
+    closure.exception = std::current_exception();
+    return -1;
+  }
+}
+
+// The map callback runs on several threads, so the first exception is kept
+// under a lock.
+struct scan_closure_t {
+  btck::scan_map const* map;
+  btck::scan_reduce const* reduce;
+  std::mutex mutex;
+  std::exception_ptr exception;
+
+  template <typename Function> auto capture(Function&& function) -> int
+  {
+    try {
+      function();
+      return 0;
+    }
+    catch (...) {
+      auto const lock = std::lock_guard{mutex};
+      if (!exception) {
+        exception = std::current_exception();
+      }
+      return -1;
+    }
+  }
+};
+
+template <typename Function>
+void export_(btck::export_sink const& sink, Function function)
+{
+  auto closure = export_closure_t{.sink = &sink};
+  auto err = btck::detail::error{};
+  int const result = function(&closure, btck::detail::out_ptr{err});
+  if (result != 0) {
+    if (closure.exception) {
+      std::rethrow_exception(closure.exception);
+    }
+    btck::detail::translate_error(err);
+  }
+}
+
 void throw_domain(
   btck::detail::error const& err, std::error_category const& domain)
 {
@@ -66,6 +130,39 @@ auto btck::detail::to_bytes_(void const* obj, to_bytes_fn writefn)
   return bytes;
 }
 
+auto btck::detail::to_json_(
+  void const* obj, to_json_fn writefn, BtcK_JsonOptions options) -> std::string
+{
+  std::string json;
+
+  struct closure_t {
+    std::string* json;
+    std::exception_ptr exception;
+  };
+
+  constexpr auto const write = +[](void const* buf, size_t len, void* user) {
+    auto& closure = *reinterpret_cast<closure_t*>(user);
+    try {
+      closure.json->append(static_cast<char const*>(buf), len);
+      return 0;
+    }
+    catch (...) {
+      closure.exception = std::current_exception();
+      return -1;
+    }
+  };
+
+  auto closure = closure_t{.json = &json};
+  if (writefn(obj, write, &closure, options) != 0) {
+    if (closure.exception) {
+      std::rethrow_exception(closure.exception);
+    }
+    throw std::invalid_argument("to_json failed");
+  }
+
+  return json;
+}
+
 auto btck::detail::to_string_(void const* obj, to_string_fn printfn)
   -> std::string
 {
@@ -77,3 +174,232 @@ auto btck::detail::to_string_(void const* obj, to_string_fn printfn)
   printfn(obj, buf.data(), len + 1);
   return buf;
 }
+
+struct btck::archive_writer::closure_t {
+  sink write;
+  std::exception_ptr exception;
+};
+
+void btck::archive_writer::closure_deleter::operator()(closure_t* closure) const
+{
+  delete closure;
+}
+
+btck::archive_writer::archive_writer(sink write, std::size_t segment_bytes)
+  : closure_{new closure_t{.write = std::move(write)}}
+{
+  constexpr auto const callback =
+    +[](void const* buf, size_t len, void* user) {
+      auto& closure = *reinterpret_cast<closure_t*>(user);
+      try {
+        closure.write(std::span{static_cast<std::byte const*>(buf), len});
+        return 0;
+      }
+      catch (...) {
+        closure.exception = std::current_exception();
+        return -1;
+      }
+    };
+
+  impl_.reset(detail::invoke(
+    BtcK_ArchiveWriter_New, callback, closure_.get(), segment_bytes));
+}
+
+void btck::archive_writer::append_(BtcK_Block const* block)
+{
+  auto err = detail::error{};
+  int const result =
+    BtcK_ArchiveWriter_Append(impl_.get(), block, detail::out_ptr{err});
+  if (result != 0) {
+    if (closure_->exception) {
+      std::rethrow_exception(std::exchange(closure_->exception, nullptr));
+    }
+    detail::translate_error(err);
+  }
+}
+
+void btck::archive_writer::finish()
+{
+  auto err = detail::error{};
+  int const result =
+    BtcK_ArchiveWriter_Finish(impl_.get(), detail::out_ptr{err});
+  if (result != 0) {
+    if (closure_->exception) {
+      std::rethrow_exception(std::exchange(closure_->exception, nullptr));
+    }
+    detail::translate_error(err);
+  }
+}
+
+void btck::export_blocks(
+  std::span<block const> blocks, export_sink const& sink, export_format format,
+  json_options options, std::size_t num_threads)
+{
+  export_(sink, [&](export_closure_t* closure, BtcK_Error** err) {
+    return BtcK_Block_ExportMany(
+      detail::get_impl(blocks.data()), blocks.size(),
+      static_cast<BtcK_ExportFormat>(format),
+      static_cast<BtcK_JsonOptions>(options), num_threads, export_callback,
+      closure, err);
+  });
+}
+
+void btck::Chain::export_blocks(
+  std::size_t first, std::size_t last, export_sink const& sink,
+  export_format format, json_options options, std::size_t num_threads) const
+{
+  export_(sink, [&](export_closure_t* closure, BtcK_Error** err) {
+    return BtcK_Chain_ExportBlocks(
+      impl_.get(), first, last, static_cast<BtcK_ExportFormat>(format),
+      static_cast<BtcK_JsonOptions>(options), num_threads, export_callback,
+      closure, err);
+  });
+}
+
+btck::Chain::KwArgs::KwArgs() : options_{} {}
+
+auto btck::Chain::import_blocks(
+  std::span<std::string const> paths, import_progress const& progress,
+  std::size_t num_threads) -> std::size_t
+{
+  struct closure_t {
+    import_progress const* progress;
+    std::exception_ptr exception;
+  };
+
+  constexpr auto const progress_cb =
+    +[](std::size_t done, std::size_t total, void* user) {
+      auto& closure = *static_cast<closure_t*>(user);
+      try {
+        (*closure.progress)(done, total);
+        return 0;
+      }
+      catch (...) {
+        closure.exception = std::current_exception();
+        return -1;
+      }
+    };
+
+  auto c_paths = std::vector<char const*>{};
+  c_paths.reserve(paths.size());
+  for (auto const& path : paths) {
+    c_paths.push_back(path.c_str());
+  }
+
+  auto closure = closure_t{.progress = &progress};
+  auto skipped = std::size_t{0};
+  auto err = detail::error{};
+  int const result = BtcK_Chain_ImportBlocks(
+    impl_.get(), c_paths.data(), c_paths.size(), num_threads,
+    progress ? progress_cb : nullptr, &closure, &skipped,
+    detail::out_ptr{err});
+  if (result != 0) {
+    if (closure.exception) {
+      std::rethrow_exception(closure.exception);
+    }
+    detail::translate_error(err);
+  }
+  return skipped;
+}
+
+void btck::Chain::parallel_scan(
+  std::size_t first, std::size_t last, std::size_t shard_size,
+  scan_map const& map, scan_reduce const& reduce,
+  std::size_t num_threads) const
+{
+  auto const map_cb = +[](std::size_t shard, std::size_t height,
+                          BtcK_Block const* block, void* user) {
+    auto& closure = *static_cast<scan_closure_t*>(user);
+    return closure.capture([&] {
+      (*closure.map)(shard, height, {detail::internal, block});
+    });
+  };
+
+  auto const reduce_cb = +[](std::size_t shard, void* user) {
+    auto& closure = *static_cast<scan_closure_t*>(user);
+    return closure.capture([&] { (*closure.reduce)(shard); });
+  };
+
+  auto closure = scan_closure_t{.map = &map, .reduce = &reduce};
+  auto err = detail::error{};
+  int const result = BtcK_Chain_ParallelScan(
+    impl_.get(), first, last, shard_size, num_threads, map_cb,
+    reduce ? reduce_cb : nullptr, &closure, detail::out_ptr{err});
+  if (result != 0) {
+    if (closure.exception) {
+      std::rethrow_exception(closure.exception);
+    }
+    detail::translate_error(err);
+  }
+}
+
+auto btck::Chain::KwArgs::chain_type(btck::chain_type arg) && -> KwArgs
+{
+  options_.chain_type = static_cast<BtcK_ChainType>(arg);
+  return std::move(*this);
+}
+
+auto btck::Chain::KwArgs::SetCacheSize(std::size_t cache_bytes) && -> KwArgs
+{
+  options_.cache_bytes = cache_bytes;
+  return std::move(*this);
+}
+
+auto btck::Chain::KwArgs::SetBlockCacheSize(
+  std::size_t block_cache_bytes) && -> KwArgs
+{
+  options_.block_cache_bytes = block_cache_bytes;
+  return std::move(*this);
+}
+
+auto btck::Chain::KwArgs::SetMaxOpenBlockFiles(
+  std::size_t max_open_block_files) && -> KwArgs
+{
+  options_.max_open_block_files = max_open_block_files;
+  return std::move(*this);
+}
+
+auto btck::Chain::KwArgs::SetWorkerThreads(int worker_threads) && -> KwArgs
+{
+  options_.worker_threads = worker_threads;
+  return std::move(*this);
+}
+
+auto btck::Chain::KwArgs::SetWipeDbs(
+  bool wipe_block_tree, bool wipe_chainstate) && -> KwArgs
+{
+  options_.wipe_block_tree_db = wipe_block_tree ? 1 : 0;
+  options_.wipe_chainstate_db = wipe_chainstate ? 1 : 0;
+  return std::move(*this);
+}
+
+auto btck::Chain::KwArgs::SetBlockTreeDbInMemory(
+  bool block_tree_db_in_memory) && -> KwArgs
+{
+  options_.block_tree_db_in_memory = block_tree_db_in_memory ? 1 : 0;
+  return std::move(*this);
+}
+
+auto btck::Chain::KwArgs::SetChainstateDbInMemory(
+  bool chainstate_db_in_memory) && -> KwArgs
+{
+  options_.chainstate_db_in_memory = chainstate_db_in_memory ? 1 : 0;
+  return std::move(*this);
+}
+
+auto btck::Chain::KwArgs::SetObfuscateBlockFiles(bool obfuscate) && -> KwArgs
+{
+  options_.disable_block_file_obfuscation = obfuscate ? 0 : 1;
+  return std::move(*this);
+}
+
+btck::Chain::Chain(
+  std::string_view data_dir, std::string_view blocks_dir, KwArgs kwargs)
+{
+  auto const data_dir_str = std::string{data_dir};
+  auto const blocks_dir_str = std::string{blocks_dir};
+  auto options = kwargs.options_;
+  options.data_dir = data_dir_str.c_str();
+  options.blocks_dir = blocks_dir.empty() ? nullptr : blocks_dir_str.c_str();
+  impl_.reset(detail::invoke(BtcK_Chain_New, &options));
+}
@@ -0,0 +1,702 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <btck/btck.h>  // IWYU pragma: associated
+#include <consensus/amount.h>
+
+#include <compressor.h>
+#include <serialize.h>
+#include <streams.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "primitives/block.h"
+#include "primitives/transaction.h"
+#include "script/script.h"
+#include "util/api.hpp"
+#include "util/error.hpp"
+#include "util/memory_stats.hpp"
+#include "util/reader_stream.hpp"
+#include "util/writer_stream.hpp"
+
+// Archive layout, all integers little endian or Core VARINTs:
+//
+//   magic
+//   segments, each one:
+//     block records, each one:
+//       80 byte header, tx count, four column sizes,
+//       columns: transactions, inputs, witnesses, outputs
+//     script dictionary: each script as VARINT(size) and raw bytes, then the
+//                        u32 offset of each script in the dictionary
+//     pubkey dictionary: 33 byte compressed public keys
+//   block index: u64 offset of each block record
+//   segment index, per segment: u64 first block, u64 offsets of both
+//                               dictionaries, u64 count of scripts, pubkeys
+//   trailer: u64 offsets of both indexes, u64 count of blocks, segments, magic
+//
+// Dictionaries only hold values that occur more than once in their segment.
+// The first time a scriptPubKey occurs, its output stores VARINT(0) and the
+// script itself, the special forms in ScriptCompression encoding and the
+// others as VARINT(size + 6) and raw bytes. Later outputs store VARINT(id + 1)
+// instead. Witness items that look like compressed public keys are stored like
+// other items the first time and as a pubkey dictionary id later. The writer
+// starts a new segment once the values it tracks for the current one exceed
+// the segment size, which bounds its memory. The reader decodes dictionary
+// entries when a block refers to them.
+
+namespace {
+
+constexpr auto const archive_magic =
+  std::to_array<unsigned char>({'B', 't', 'c', 'K', 'A', 'r', 'c', 0x02});
+
+constexpr std::size_t pubkey_size = 33;
+constexpr std::size_t segment_entry_size = 5 * sizeof(std::uint64_t);
+constexpr std::size_t trailer_size =
+  4 * sizeof(std::uint64_t) + archive_magic.size();
+constexpr std::size_t flush_size = 64 * 1024;
+constexpr std::size_t default_segment_bytes = std::size_t{64} << 20;
+
+auto IsPubkey(std::span<unsigned char const> item) -> bool
+{
+  return item.size() == pubkey_size && (item[0] == 0x02 || item[0] == 0x03);
+}
+
+auto AsKey(std::span<unsigned char const> bytes) -> std::string
+{
+  return {reinterpret_cast<char const*>(bytes.data()), bytes.size()};
+}
+
+auto AsBytes(DataStream const& stream) -> std::span<std::byte const>
+{
+  return {stream.data(), stream.size()};
+}
+
+[[noreturn]] void ThrowCorrupt()
+{
+  throw std::runtime_error("Corrupt block archive.");
+}
+
+// Every element of a column takes at least one byte.
+void CheckCount(std::uint64_t count, util::ReaderStream const& column)
+{
+  if (count > column.size()) {
+    ThrowCorrupt();
+  }
+}
+
+// Unlike Using<ScriptCompression>, which replaces scripts above
+// MAX_SCRIPT_SIZE with OP_RETURN when reading, this keeps every script as is.
+void WriteScript(DataStream& stream, std::span<unsigned char const> script)
+{
+  auto compressed = CompressedScript{};
+  if (CompressScript(CScript(script.begin(), script.end()), compressed)) {
+    stream << std::span{compressed.data(), compressed.size()};
+    return;
+  }
+  auto const size = script.size() + ScriptCompression::nSpecialScripts;
+  stream << VARINT(std::uint64_t{size}) << script;
+}
+
+auto ReadScript(util::ReaderStream& stream) -> CScript
+{
+  auto size = std::uint64_t{0};
+  stream >> VARINT(size);
+  auto script = CScript{};
+  if (size < ScriptCompression::nSpecialScripts) {
+    auto const kind = static_cast<unsigned>(size);
+    auto compressed = CompressedScript(GetSpecialScriptSize(kind));
+    stream >> std::span{compressed.data(), compressed.size()};
+    if (!DecompressScript(script, kind, compressed)) {
+      ThrowCorrupt();
+    }
+    return script;
+  }
+  size -= ScriptCompression::nSpecialScripts;
+  CheckCount(size, stream);
+  script.resize(static_cast<CScript::size_type>(size));
+  stream >> std::span{script.data(), script.size()};
+  return script;
+}
+
+// The values seen in the current segment. A value gets an id when it is seen
+// the second time, so values that occur once stay out of the dictionary.
+class Dictionary
+{
+public:
+  // Zero the first time `bytes` are seen, one more than their id after that.
+  auto Code(std::span<unsigned char const> bytes) -> std::uint64_t
+  {
+    auto const [it, inserted] = codes_.try_emplace(AsKey(bytes), 0);
+    if (inserted) {
+      tracked_bytes_ += it->first.size() + entry_overhead;
+    }
+    else if (it->second == 0) {
+      keys_.push_back(&it->first);
+      it->second = keys_.size();
+    }
+    return inserted ? 0 : it->second;
+  }
+
+  [[nodiscard]] auto Keys() const -> std::span<std::string const* const>
+  {
+    return keys_;
+  }
+
+  // Rough memory held for the values seen, including the map nodes.
+  [[nodiscard]] auto TrackedBytes() const -> std::size_t
+  {
+    return tracked_bytes_;
+  }
+
+  void Clear()
+  {
+    codes_.clear();
+    keys_.clear();
+    tracked_bytes_ = 0;
+  }
+
+private:
+  static constexpr std::size_t entry_overhead = 96;
+
+  std::unordered_map<std::string, std::uint64_t> codes_;
+  std::vector<std::string const*> keys_;
+  std::size_t tracked_bytes_ = 0;
+};
+
+struct Segment {
+  std::uint64_t first_block = 0;
+  std::uint64_t script_dict_offset = 0;
+  std::uint64_t pubkey_dict_offset = 0;
+  std::uint64_t num_scripts = 0;
+  std::uint64_t num_pubkeys = 0;
+};
+
+}  // namespace
+
+struct BtcK_ArchiveWriter {
+  BtcK_ArchiveWriter(
+    BtcK_WriteBytes write, void* userdata, std::size_t segment_bytes)
+    : stream{write, userdata}
+    , segment_bytes{segment_bytes != 0 ? segment_bytes : default_segment_bytes}
+  {
+    Write(std::as_bytes(std::span{archive_magic}));
+  }
+
+  void Append(CBlock const& block);
+  void Finish();
+
+  // Writes the dictionaries of the current segment and starts the next one.
+  void CloseSegment();
+
+  void Write(std::span<std::byte const> bytes)
+  {
+    stream.write(bytes);
+    offset += bytes.size();
+  }
+
+  // Writes out `buffer` once it holds flush_size bytes, or if `force`.
+  void Flush(DataStream& buffer, bool force)
+  {
+    if (force || buffer.size() >= flush_size) {
+      Write(AsBytes(buffer));
+      buffer.clear();
+    }
+  }
+
+  util::WriterStream stream;
+  std::size_t segment_bytes;
+  std::uint64_t offset = 0;
+  bool finished = false;
+  bool segment_open = false;
+  std::vector<std::uint64_t> block_offsets;
+  std::vector<Segment> segments;
+  Dictionary scripts;
+  Dictionary pubkeys;
+};
+
+void BtcK_ArchiveWriter::Append(CBlock const& block)
+{
+  if (finished) {
+    throw std::logic_error("Block archive already finished.");
+  }
+
+  auto txs = DataStream{};
+  auto inputs = DataStream{};
+  auto witnesses = DataStream{};
+  auto outputs = DataStream{};
+
+  for (auto const& tx : block.vtx) {
+    auto const has_witness = tx->HasWitness();
+    txs << VARINT(tx->version) << VARINT(tx->nLockTime)
+        << VARINT(std::uint64_t{tx->vin.size()})
+        << VARINT(std::uint64_t{tx->vout.size()})
+        << std::uint8_t{has_witness};
+
+    for (auto const& txin : tx->vin) {
+      // The null prevout of a coinbase is a single zero, other prevouts
+      // store their index offset by one before the hash. Inverts the
+      // sequence so that the common final values stay small.
+      if (txin.prevout.IsNull()) {
+        inputs << VARINT(std::uint64_t{0});
+      }
+      else {
+        inputs << VARINT(std::uint64_t{txin.prevout.n} + 1)
+               << txin.prevout.hash;
+      }
+      inputs << txin.scriptSig << VARINT(~txin.nSequence);
+      if (!has_witness) {
+        continue;
+      }
+      auto const& stack = txin.scriptWitness.stack;
+      witnesses << VARINT(std::uint64_t{stack.size()});
+      for (auto const& item : stack) {
+        auto const code = IsPubkey(item) ? pubkeys.Code(item) : 0;
+        if (code != 0) {
+          witnesses << VARINT(std::uint64_t{0}) << VARINT(code - 1);
+        }
+        else {
+          witnesses << VARINT(std::uint64_t{item.size() + 1})
+                    << std::span{item};
+        }
+      }
+    }
+
+    for (auto const& txout : tx->vout) {
+      // The amount compression is only reversible for valid amounts.
+      if (!MoneyRange(txout.nValue)) {
+        throw std::out_of_range("Amount out of range.");
+      }
+      auto const code = scripts.Code(txout.scriptPubKey);
+      outputs << VARINT(CompressAmount(txout.nValue)) << VARINT(code);
+      if (code == 0) {
+        WriteScript(outputs, txout.scriptPubKey);
+      }
+    }
+  }
+
+  auto head = DataStream{};
+  head << static_cast<CBlockHeader const&>(block);
+  WriteCompactSize(head, block.vtx.size());
+  for (auto const* column : {&txs, &inputs, &witnesses, &outputs}) {
+    WriteCompactSize(head, column->size());
+  }
+
+  if (!segment_open) {
+    segments.push_back(Segment{.first_block = block_offsets.size()});
+    segment_open = true;
+  }
+  block_offsets.push_back(offset);
+  Write(AsBytes(head));
+  for (auto const* column : {&txs, &inputs, &witnesses, &outputs}) {
+    Write(AsBytes(*column));
+  }
+
+  if (scripts.TrackedBytes() + pubkeys.TrackedBytes() >= segment_bytes) {
+    CloseSegment();
+  }
+}
+
+void BtcK_ArchiveWriter::CloseSegment()
+{
+  auto& segment = segments.back();
+  auto buffer = DataStream{};
+
+  segment.script_dict_offset = offset;
+  auto script_offsets = std::vector<std::uint32_t>{};
+  script_offsets.reserve(scripts.Keys().size());
+  auto script_bytes = std::uint64_t{0};
+  for (auto const* key : scripts.Keys()) {
+    if (script_bytes > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::length_error("Script dictionary too large.");
+    }
+    script_offsets.push_back(static_cast<std::uint32_t>(script_bytes));
+    auto const before = buffer.size();
+    buffer << VARINT(std::uint64_t{key->size()})
+           << std::as_bytes(std::span{*key});
+    script_bytes += buffer.size() - before;
+    Flush(buffer, false);
+  }
+  for (auto const script_offset : script_offsets) {
+    buffer << script_offset;
+    Flush(buffer, false);
+  }
+  Flush(buffer, true);
+
+  segment.pubkey_dict_offset = offset;
+  for (auto const* key : pubkeys.Keys()) {
+    buffer << std::as_bytes(std::span{*key});
+    Flush(buffer, false);
+  }
+  Flush(buffer, true);
+
+  segment.num_scripts = scripts.Keys().size();
+  segment.num_pubkeys = pubkeys.Keys().size();
+  scripts.Clear();
+  pubkeys.Clear();
+  segment_open = false;
+}
+
+void BtcK_ArchiveWriter::Finish()
+{
+  if (finished) {
+    throw std::logic_error("Block archive already finished.");
+  }
+  finished = true;
+
+  if (segment_open) {
+    CloseSegment();
+  }
+
+  auto buffer = DataStream{};
+
+  auto const block_index_offset = offset;
+  for (auto const block_offset : block_offsets) {
+    buffer << block_offset;
+    Flush(buffer, false);
+  }
+  Flush(buffer, true);
+
+  auto const segment_index_offset = offset;
+  for (auto const& segment : segments) {
+    buffer << segment.first_block << segment.script_dict_offset
+           << segment.pubkey_dict_offset << segment.num_scripts
+           << segment.num_pubkeys;
+    Flush(buffer, false);
+  }
+
+  buffer << block_index_offset << segment_index_offset
+         << std::uint64_t{block_offsets.size()}
+         << std::uint64_t{segments.size()}
+         << std::as_bytes(std::span{archive_magic});
+  Flush(buffer, true);
+}
+
+struct BtcK_ArchiveReader {
+  explicit BtcK_ArchiveReader(std::span<std::byte const> data);
+
+  [[nodiscard]] auto GetBlock(std::size_t idx) const -> CBlock;
+
+  // Offset of the block record, read from the block index.
+  [[nodiscard]] auto BlockOffset(std::size_t idx) const -> std::uint64_t;
+
+  // Offset where the pubkey dictionary of the segment ends.
+  [[nodiscard]] auto SegmentEnd(std::size_t seg) const -> std::uint64_t;
+
+  [[nodiscard]] auto GetScript(Segment const& segment, std::uint64_t id) const
+    -> CScript;
+  [[nodiscard]] auto GetPubkey(Segment const& segment, std::uint64_t id) const
+    -> std::vector<unsigned char>;
+
+  std::span<std::byte const> data;
+  std::uint64_t block_index_offset = 0;
+  std::uint64_t num_blocks = 0;
+  std::vector<Segment> segments;
+};
+
+BtcK_ArchiveReader::BtcK_ArchiveReader(std::span<std::byte const> data)
+  : data{data}
+{
+  auto const magic = std::as_bytes(std::span{archive_magic});
+  if (
+    data.size() < magic.size() + trailer_size ||
+    !std::ranges::equal(data.first(magic.size()), magic) ||
+    !std::ranges::equal(data.last(magic.size()), magic)) {
+    throw std::runtime_error("Not a block archive.");
+  }
+
+  auto const trailer_offset = data.size() - trailer_size;
+  auto trailer = util::ReaderStream{data.subspan(trailer_offset)};
+  auto segment_index_offset = std::uint64_t{0};
+  auto num_segments = std::uint64_t{0};
+  trailer >> block_index_offset >> segment_index_offset >> num_blocks >>
+    num_segments;
+
+  if (
+    block_index_offset < magic.size() ||
+    segment_index_offset < block_index_offset ||
+    trailer_offset < segment_index_offset ||
+    (segment_index_offset - block_index_offset) / sizeof(std::uint64_t) !=
+      num_blocks ||
+    (trailer_offset - segment_index_offset) / segment_entry_size !=
+      num_segments ||
+    (num_blocks == 0) != (num_segments == 0)) {
+    ThrowCorrupt();
+  }
+
+  // The segment index is small, one entry per segment of blocks.
+  auto index = util::ReaderStream{data.subspan(
+    segment_index_offset, trailer_offset - segment_index_offset)};
+  segments.resize(num_segments);
+  for (std::size_t seg = 0; seg < segments.size(); ++seg) {
+    auto& segment = segments[seg];
+    index >> segment.first_block >> segment.script_dict_offset >>
+      segment.pubkey_dict_offset >> segment.num_scripts >> segment.num_pubkeys;
+    auto const* prev = (seg != 0) ? &segments[seg - 1] : nullptr;
+    auto const begin = (prev != nullptr) ? prev->pubkey_dict_offset
+                                         : std::uint64_t{magic.size()};
+    if (
+      (prev != nullptr ? segment.first_block <= prev->first_block
+                       : segment.first_block != 0) ||
+      segment.first_block >= num_blocks ||
+      segment.script_dict_offset < begin ||
+      segment.pubkey_dict_offset < segment.script_dict_offset ||
+      (segment.pubkey_dict_offset - segment.script_dict_offset) /
+          sizeof(std::uint32_t) <
+        segment.num_scripts) {
+      ThrowCorrupt();
+    }
+  }
+  for (std::size_t seg = 0; seg < segments.size(); ++seg) {
+    auto const& segment = segments[seg];
+    auto const end = SegmentEnd(seg);
+    if (
+      end < segment.pubkey_dict_offset ||
+      (end - segment.pubkey_dict_offset) % pubkey_size != 0 ||
+      (end - segment.pubkey_dict_offset) / pubkey_size != segment.num_pubkeys) {
+      ThrowCorrupt();
+    }
+  }
+}
+
+auto BtcK_ArchiveReader::BlockOffset(std::size_t idx) const -> std::uint64_t
+{
+  auto entry = util::ReaderStream{data.subspan(
+    block_index_offset + idx * sizeof(std::uint64_t), sizeof(std::uint64_t))};
+  auto offset = std::uint64_t{0};
+  entry >> offset;
+  return offset;
+}
+
+auto BtcK_ArchiveReader::SegmentEnd(std::size_t seg) const -> std::uint64_t
+{
+  return (seg + 1 < segments.size())
+    ? BlockOffset(segments[seg + 1].first_block)
+    : block_index_offset;
+}
+
+auto BtcK_ArchiveReader::GetBlock(std::size_t idx) const -> CBlock
+{
+  if (idx >= num_blocks) {
+    throw std::out_of_range("Block index out of range.");
+  }
+  auto const next = std::ranges::upper_bound(
+    segments, std::uint64_t{idx}, {}, &Segment::first_block);
+  auto const seg = static_cast<std::size_t>(next - segments.begin()) - 1;
+  auto const& segment = segments[seg];
+  auto const last = (next != segments.end()) ? next->first_block : num_blocks;
+  auto const begin = BlockOffset(idx);
+  auto const end =
+    (idx + 1 < last) ? BlockOffset(idx + 1) : segment.script_dict_offset;
+  auto const segment_begin =
+    (seg != 0) ? SegmentEnd(seg - 1) : std::uint64_t{archive_magic.size()};
+  if (
+    begin < segment_begin || end < begin ||
+    end > segment.script_dict_offset) {
+    ThrowCorrupt();
+  }
+  auto record = util::ReaderStream{data.subspan(begin, end - begin)};
+
+  auto block = CBlock{};
+  record >> static_cast<CBlockHeader&>(block);
+  auto const num_txs = ReadCompactSize(record);
+  auto sizes = std::array<std::uint64_t, 4>{};
+  for (auto& size : sizes) {
+    size = ReadCompactSize(record);
+  }
+  auto txs = record.substream(sizes[0]);
+  auto inputs = record.substream(sizes[1]);
+  auto witnesses = record.substream(sizes[2]);
+  auto outputs = record.substream(sizes[3]);
+
+  CheckCount(num_txs, txs);
+  block.vtx.reserve(num_txs);
+  for (std::uint64_t i = 0; i < num_txs; ++i) {
+    auto tx = CMutableTransaction{};
+    auto num_inputs = std::uint64_t{0};
+    auto num_outputs = std::uint64_t{0};
+    auto has_witness = std::uint8_t{0};
+    txs >> VARINT(tx.version) >> VARINT(tx.nLockTime) >> VARINT(num_inputs) >>
+      VARINT(num_outputs) >> has_witness;
+
+    CheckCount(num_inputs, inputs);
+    tx.vin.resize(num_inputs);
+    for (auto& txin : tx.vin) {
+      auto n = std::uint64_t{0};
+      auto sequence = std::uint32_t{0};
+      inputs >> VARINT(n);
+      if (n == 0) {
+        txin.prevout.SetNull();
+      }
+      else if (n - 1 > std::numeric_limits<std::uint32_t>::max()) {
+        ThrowCorrupt();
+      }
+      else {
+        inputs >> txin.prevout.hash;
+        txin.prevout.n = static_cast<std::uint32_t>(n - 1);
+      }
+      inputs >> txin.scriptSig >> VARINT(sequence);
+      txin.nSequence = ~sequence;
+      if (has_witness == 0) {
+        continue;
+      }
+      auto num_items = std::uint64_t{0};
+      witnesses >> VARINT(num_items);
+      CheckCount(num_items, witnesses);
+      auto& stack = txin.scriptWitness.stack;
+      stack.resize(num_items);
+      for (auto& item : stack) {
+        auto tag = std::uint64_t{0};
+        witnesses >> VARINT(tag);
+        if (tag == 0) {
+          auto id = std::uint64_t{0};
+          witnesses >> VARINT(id);
+          item = GetPubkey(segment, id);
+        }
+        else {
+          CheckCount(tag - 1, witnesses);
+          item.resize(tag - 1);
+          witnesses >> std::span{item};
+        }
+      }
+    }
+
+    CheckCount(num_outputs, outputs);
+    tx.vout.resize(num_outputs);
+    for (auto& txout : tx.vout) {
+      auto amount = std::uint64_t{0};
+      auto code = std::uint64_t{0};
+      outputs >> VARINT(amount) >> VARINT(code);
+      txout.nValue = static_cast<CAmount>(DecompressAmount(amount));
+      txout.scriptPubKey =
+        (code == 0) ? ReadScript(outputs) : GetScript(segment, code - 1);
+    }
+
+    block.vtx.push_back(MakeTransactionRef(std::move(tx)));
+  }
+
+  if (
+    !txs.empty() || !inputs.empty() || !witnesses.empty() ||
+    !outputs.empty()) {
+    ThrowCorrupt();
+  }
+  return block;
+}
+
+auto BtcK_ArchiveReader::GetScript(
+  Segment const& segment, std::uint64_t id) const -> CScript
+{
+  if (id >= segment.num_scripts) {
+    ThrowCorrupt();
+  }
+  auto const table_offset =
+    segment.pubkey_dict_offset - segment.num_scripts * sizeof(std::uint32_t);
+  auto entry = util::ReaderStream{
+    data.subspan(table_offset + id * sizeof(std::uint32_t))};
+  auto script_offset = std::uint32_t{0};
+  entry >> script_offset;
+  if (script_offset > table_offset - segment.script_dict_offset) {
+    ThrowCorrupt();
+  }
+
+  auto dict = util::ReaderStream{data.subspan(
+    segment.script_dict_offset + script_offset,
+    table_offset - segment.script_dict_offset - script_offset)};
+  auto size = std::uint64_t{0};
+  dict >> VARINT(size);
+  CheckCount(size, dict);
+  auto script = CScript{};
+  script.resize(static_cast<CScript::size_type>(size));
+  dict >> std::span{script.data(), script.size()};
+  return script;
+}
+
+auto BtcK_ArchiveReader::GetPubkey(
+  Segment const& segment, std::uint64_t id) const -> std::vector<unsigned char>
+{
+  if (id >= segment.num_pubkeys) {
+    ThrowCorrupt();
+  }
+  auto const pubkey =
+    data.subspan(segment.pubkey_dict_offset + id * pubkey_size, pubkey_size);
+  auto const* first = reinterpret_cast<unsigned char const*>(pubkey.data());
+  return {first, first + pubkey.size()};
+}
+
+extern "C" {
+
+auto BtcK_ArchiveWriter_New(
+  BtcK_WriteBytes write, void* userdata, std::size_t segment_bytes,
+  BtcK_Error** err) -> BtcK_ArchiveWriter*
+{
+  return util::WrapFn(err, [=] {
+    return new BtcK_ArchiveWriter(write, userdata, segment_bytes);
+  });
+}
+
+void BtcK_ArchiveWriter_Free(BtcK_ArchiveWriter* self)
+{
+  delete self;
+}
+
+auto BtcK_ArchiveWriter_Append(
+  BtcK_ArchiveWriter* self, BtcK_Block const* block, BtcK_Error** err) -> int
+{
+  auto const ok = util::WrapFn(err, [self, block] {
+    self->Append(*api::get(block));
+    return true;
+  });
+  return ok ? 0 : -1;
+}
+
+auto BtcK_ArchiveWriter_Finish(BtcK_ArchiveWriter* self, BtcK_Error** err)
+  -> int
+{
+  auto const ok = util::WrapFn(err, [self] {
+    self->Finish();
+    return true;
+  });
+  return ok ? 0 : -1;
+}
+
+auto BtcK_ArchiveReader_New(void const* data, std::size_t len, BtcK_Error** err)
+  -> BtcK_ArchiveReader*
+{
+  return util::WrapFn(err, [data, len] {
+    return new BtcK_ArchiveReader(
+      std::span{static_cast<std::byte const*>(data), len});
+  });
+}
+
+void BtcK_ArchiveReader_Free(BtcK_ArchiveReader* self)
+{
+  delete self;
+}
+
+auto BtcK_ArchiveReader_CountBlocks(BtcK_ArchiveReader const* self)
+  -> std::size_t
+{
+  return self->num_blocks;
+}
+
+auto BtcK_ArchiveReader_GetBlock(
+  BtcK_ArchiveReader const* self, std::size_t idx, BtcK_Error** err)
+  -> BtcK_Block*
+{
+  return util::WrapFn(err, [self, idx] {
+    return api::create<CBlockRef>(util::MakeShared<CBlock>(self->GetBlock(idx)));
+  });
+}
+
+}  // extern "C"
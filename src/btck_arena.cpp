@@ -0,0 +1,28 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <btck/btck.h>  // IWYU pragma: associated
+
+#include "util/api.hpp"
+#include "util/arena.hpp"
+#include "util/error.hpp"
+
+extern "C" {
+
+auto BtcK_Arena_New(BtcK_Error** err) -> BtcK_Arena*
+{
+  return util::WrapFn(err, [] { return api::create<util::Arena>(); });
+}
+
+void BtcK_Arena_Reset(BtcK_Arena* self)
+{
+  api::get(self).Reset();
+}
+
+void BtcK_Arena_Free(BtcK_Arena* self)
+{
+  api::free(self);
+}
+
+}  // extern "C"
@@ -11,6 +11,7 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <span>
 #include <string>
 #include <utility>
@@ -22,19 +23,38 @@
 #include "uint256.h"
 #include "util/api.hpp"
 #include "util/error.hpp"
+#include "util/export.hpp"
+#include "util/json.hpp"
+#include "util/memory_stats.hpp"
 #include "util/writer_stream.hpp"
 
+namespace {
+
+auto Parse(void const* raw, std::size_t len) -> CBlockRef
+{
+  auto const data = std::span{reinterpret_cast<std::byte const*>(raw), len};
+  auto block = CBlock{};
+  auto stream = DataStream{data};
+  stream >> TX_WITH_WITNESS(block);
+  return util::MakeShared<CBlock>(std::move(block));
+}
+
+}  // namespace
+
 extern "C" {
 
 auto BtcK_Block_New(void const* raw, std::size_t len, struct BtcK_Error** err)
   -> BtcK_Block*
 {
-  return util::WrapFn(err, [raw, len] {
-    auto const data = std::span{reinterpret_cast<std::byte const*>(raw), len};
-    auto block = CBlock{};
-    auto stream = DataStream{data};
-    stream >> TX_WITH_WITNESS(block);
-    return api::create<CBlock>(std::move(block));
+  return BtcK_Block_NewIn(nullptr, raw, len, err);
+}
+
+auto BtcK_Block_NewIn(
+  BtcK_Arena* arena, void const* raw, std::size_t len, struct BtcK_Error** err)
+  -> BtcK_Block*
+{
+  return util::WrapFn(err, [arena, raw, len] {
+    return api::create_in<CBlockRef>(arena, Parse(raw, len));
   });
 }
 
@@ -44,26 +64,78 @@ auto BtcK_Block_Copy(BtcK_Block const* self, struct BtcK_Error** err)
   return api::copy(self, err);
 }
 
+auto BtcK_Block_CopyIn(
+  BtcK_Arena* arena, BtcK_Block const* self, struct BtcK_Error** err)
+  -> BtcK_Block*
+{
+  return api::copy_in(arena, self, err);
+}
+
 void BtcK_Block_Free(BtcK_Block* self)
 {
   api::free(self);
 }
 
+auto BtcK_Block_SizeOf() -> std::size_t
+{
+  return sizeof(CBlockRef);
+}
+
+auto BtcK_Block_AlignOf() -> std::size_t
+{
+  return alignof(CBlockRef);
+}
+
+auto BtcK_Block_InitAt(
+  void* storage, void const* raw, std::size_t len, struct BtcK_Error** err)
+  -> BtcK_Block*
+{
+  return util::WrapFn(err, [storage, raw, len] {
+    return api::create_at<CBlockRef>(storage, Parse(raw, len));
+  });
+}
+
+auto BtcK_Block_CopyAt(
+  void* storage, BtcK_Block const* self, struct BtcK_Error** err)
+  -> BtcK_Block*
+{
+  return api::copy_at(storage, self, err);
+}
+
+void BtcK_Block_Destroy(BtcK_Block* self)
+{
+  api::destroy(self);
+}
+
+auto BtcK_Block_DynamicMemoryUsage(BtcK_Block const* self) -> std::size_t
+{
+  return util::DynamicMemoryUsage(api::get(self));
+}
+
 void BtcK_Block_GetHash(BtcK_Block const* self, BtcK_BlockHash* out)
 {
-  auto const hash = api::get(self).GetHash();
+  auto const hash = api::get(self)->GetHash();
   BtcK_BlockHash_Init(out, hash.data(), decltype(hash)::size());
 }
 
 auto BtcK_Block_CountTransactions(BtcK_Block const* self) -> std::size_t
 {
-  return api::get(self).vtx.size();
+  return api::get(self)->vtx.size();
 }
 
 auto BtcK_Block_GetTransaction(BtcK_Block const* self, std::size_t idx)
   -> BtcK_Transaction const*
 {
-  return api::ref(api::get(self).vtx[idx]);
+  return api::ref(api::get(self)->vtx[idx]);
+}
+
+auto BtcK_Block_GetTransactionRef(
+  BtcK_Block const* self, std::size_t idx, struct BtcK_Error** err)
+  -> BtcK_Transaction*
+{
+  return util::WrapFn(err, [self, idx] {
+    return api::create<CTransactionRef>(api::get(self)->vtx.at(idx));
+  });
 }
 
 auto BtcK_Block_ToBytes(
@@ -71,7 +143,7 @@ auto BtcK_Block_ToBytes(
 {
   try {
     auto stream = util::WriterStream{write, userdata};
-    stream << TX_WITH_WITNESS(api::get(self));
+    stream << TX_WITH_WITNESS(*api::get(self));
     return 0;
   }
   catch (...) {
@@ -79,6 +151,100 @@ auto BtcK_Block_ToBytes(
   }
 }
 
+auto BtcK_Block_ExportColumns(
+  BtcK_Block const* self, BtcK_BlockColumns* columns) -> int
+{
+  auto const& block = *api::get(self);
+
+  auto num_outputs = std::size_t{0};
+  auto script_data_len = std::size_t{0};
+  for (auto const& tx : block.vtx) {
+    num_outputs += tx->vout.size();
+    for (auto const& txout : tx->vout) {
+      script_data_len += txout.scriptPubKey.size();
+    }
+  }
+
+  // Offsets are Arrow-style, with the end of the last script appended.
+  bool const fits = num_outputs <= columns->num_outputs &&
+    (columns->script_offsets == nullptr ||
+     num_outputs + 1 <= columns->script_offsets_len) &&
+    script_data_len <= columns->script_data_len;
+  columns->num_outputs = num_outputs;
+  columns->script_offsets_len = num_outputs + 1;
+  columns->script_data_len = script_data_len;
+  if (!fits) {
+    return -1;
+  }
+
+  auto row = std::size_t{0};
+  auto offset = std::uint32_t{0};
+  if (columns->script_offsets != nullptr) {
+    columns->script_offsets[0] = 0;
+  }
+  for (std::size_t tx_idx = 0; tx_idx < block.vtx.size(); ++tx_idx) {
+    auto const& vout = block.vtx[tx_idx]->vout;
+    for (std::size_t out_idx = 0; out_idx < vout.size(); ++out_idx, ++row) {
+      auto const& script = vout[out_idx].scriptPubKey;
+      if (columns->amounts != nullptr) {
+        columns->amounts[row] = vout[out_idx].nValue;
+      }
+      if (columns->script_data != nullptr) {
+        std::copy(script.begin(), script.end(), columns->script_data + offset);
+      }
+      offset += static_cast<std::uint32_t>(script.size());
+      if (columns->script_offsets != nullptr) {
+        columns->script_offsets[row + 1] = offset;
+      }
+      if (columns->tx_index != nullptr) {
+        columns->tx_index[row] = static_cast<std::uint32_t>(tx_idx);
+      }
+      if (columns->output_index != nullptr) {
+        columns->output_index[row] = static_cast<std::uint32_t>(out_idx);
+      }
+    }
+  }
+
+  return 0;
+}
+
+auto BtcK_Block_ToJson(
+  BtcK_Block const* self, BtcK_WriteBytes write, void* userdata,
+  BtcK_JsonOptions options) -> int
+{
+  if ((options & ~BtcK_JsonOptions_ALL) != 0) {
+    return -1;
+  }
+
+  try {
+    auto json = util::JsonWriter{write, userdata};
+    util::WriteBlockJson(json, *api::get(self), options);
+    json.Flush();
+    return 0;
+  }
+  catch (...) {
+    return -1;
+  }
+}
+
+auto BtcK_Block_ExportMany(
+  BtcK_Block const* const* blocks, std::size_t blocks_len,
+  BtcK_ExportFormat format, BtcK_JsonOptions options, std::size_t num_threads,
+  BtcK_ExportSink sink, void* userdata, struct BtcK_Error** err) -> int
+{
+  auto const ok = util::WrapFn(err, [=] {
+    util::CheckExportFormat(format, options);
+    util::ExportOrdered(
+      blocks_len, num_threads,
+      [=](std::size_t idx, std::vector<std::byte>& out) {
+        util::ExportBlock(*api::get(blocks[idx]), format, options, out);
+      },
+      util::SinkConsumer(sink, userdata, 0));
+    return true;
+  });
+  return ok ? 0 : -1;
+}
+
 void BtcK_BlockHash_Init(
   struct BtcK_BlockHash* self, void const* raw, std::size_t len)
 {
@@ -90,7 +256,7 @@ void BtcK_BlockHash_Init(
 
 auto BtcK_Block_ToString(BtcK_Block const* self, char* buf, size_t len) -> int
 {
-  auto const str = api::get(self).ToString();
+  auto const str = api::get(self)->ToString();
   str.copy(buf, len);
   return static_cast<int>(str.size());
 }
@@ -0,0 +1,127 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <btck/btck.h>  // IWYU pragma: associated
+
+#include <btck/btck_error.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "block_undo.hpp"
+#include "coins.h"
+#include "primitives/block.h"
+#include "primitives/transaction.h"
+#include "script/interpreter.h"
+#include "util/api.hpp"
+#include "util/error.hpp"
+#include "util/verify.hpp"
+
+BtcK_BlockUndo::BtcK_BlockUndo(CBlockUndo block_undo)
+  : undo{std::move(block_undo)}
+{
+  offsets.reserve(undo.vtxundo.size() + 2);
+  offsets.push_back(0);
+  offsets.push_back(0);
+  for (auto const& txundo : undo.vtxundo) {
+    for (auto const& coin : txundo.vprevout) {
+      spent_outputs.push_back(api::ref(coin.out));
+    }
+    offsets.push_back(spent_outputs.size());
+  }
+}
+
+auto BtcK_BlockUndo::SpentCoin(std::size_t tx_idx, std::size_t input_idx) const
+  -> Coin const&
+{
+  return undo.vtxundo[tx_idx - 1].vprevout[input_idx];
+}
+
+extern "C" {
+
+void BtcK_BlockUndo_Free(BtcK_BlockUndo* self)
+{
+  delete self;
+}
+
+auto BtcK_BlockUndo_CountTransactions(BtcK_BlockUndo const* self)
+  -> std::size_t
+{
+  return self->offsets.size() - 1;
+}
+
+auto BtcK_BlockUndo_CountSpentOutputs(
+  BtcK_BlockUndo const* self, std::size_t tx_idx) -> std::size_t
+{
+  return self->offsets[tx_idx + 1] - self->offsets[tx_idx];
+}
+
+auto BtcK_BlockUndo_GetSpentOutputs(
+  BtcK_BlockUndo const* self, std::size_t tx_idx)
+  -> BtcK_TransactionOutput const* const*
+{
+  return self->spent_outputs.data() + self->offsets[tx_idx];
+}
+
+auto BtcK_BlockUndo_GetSpentOutputHeight(
+  BtcK_BlockUndo const* self, std::size_t tx_idx, std::size_t input_idx)
+  -> std::uint32_t
+{
+  return self->SpentCoin(tx_idx, input_idx).nHeight;
+}
+
+auto BtcK_BlockUndo_IsSpentOutputCoinbase(
+  BtcK_BlockUndo const* self, std::size_t tx_idx, std::size_t input_idx)
+  -> int
+{
+  return self->SpentCoin(tx_idx, input_idx).IsCoinBase() ? 1 : 0;
+}
+
+auto BtcK_Block_VerifyScripts(
+  BtcK_Block const* block, BtcK_BlockUndo const* undo,
+  BtcK_VerificationFlags flags, struct BtcK_Error** err) -> int
+{
+  return util::WrapFn(err, [=] {
+    util::CheckVerificationFlags(flags);
+
+    auto const& txs = api::get(block)->vtx;
+    if (txs.size() != undo->undo.vtxundo.size() + 1) {
+      throw std::system_error(
+        btck::verification_error::spent_outputs_mismatch);
+    }
+
+    for (std::size_t tx_idx = 1; tx_idx < txs.size(); ++tx_idx) {
+      auto const& tx = *txs[tx_idx];
+      auto const& coins = undo->undo.vtxundo[tx_idx - 1].vprevout;
+      if (coins.size() != tx.vin.size()) {
+        throw std::system_error(
+          btck::verification_error::spent_outputs_mismatch);
+      }
+
+      auto spent_outputs = std::vector<CTxOut>{};
+      spent_outputs.reserve(coins.size());
+      for (auto const& coin : coins) {
+        spent_outputs.push_back(coin.out);
+      }
+      auto txdata = PrecomputedTransactionData{};
+      txdata.Init(tx, std::move(spent_outputs));
+
+      for (unsigned int idx = 0; idx < tx.vin.size(); ++idx) {
+        auto const& spent = coins[idx].out;
+        auto const checker = TransactionSignatureChecker(
+          &tx, idx, spent.nValue, txdata, MissingDataBehavior::FAIL);
+        if (!VerifyScript(
+              tx.vin[idx].scriptSig, spent.scriptPubKey,
+              &tx.vin[idx].scriptWitness, flags, checker, nullptr)) {
+          return 0;
+        }
+      }
+    }
+    return 1;
+  });
+}
+
+}  // extern "C"
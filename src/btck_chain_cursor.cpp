@@ -0,0 +1,196 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <btck/btck.h>  // IWYU pragma: associated
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "chain.hpp"
+#include "util/api.hpp"
+#include "util/chain_snapshot.hpp"
+#include "util/error.hpp"
+#include "util/memory_stats.hpp"
+
+// Reads the blocks of a height range in order. Worker threads read and decode
+// up to `queue_depth` blocks ahead of the caller, and stop reading ahead while
+// the blocks that wait in the queue or are being read hold more than
+// `max_bytes`. A block being read counts as the average size of the blocks
+// read so far, so the budget is exceeded by at most the error of that guess,
+// and before the first block is read by one block per thread. Blocks are read
+// past the block cache, so a scan does not evict the blocks cached for others.
+struct BtcK_ChainCursor {
+  BtcK_ChainCursor(
+    BtcK_Chain const& chain, std::vector<util::ChainEntry> entries,
+    std::size_t queue_depth, std::size_t max_bytes, std::size_t num_threads)
+    : chain_{chain}
+    , entries_{std::move(entries)}
+    , max_bytes_{max_bytes != 0 ? max_bytes
+                                 : std::numeric_limits<std::size_t>::max()}
+  {
+    if (num_threads == 0) {
+      num_threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    num_threads = std::min(num_threads, entries_.size());
+    slots_.resize(queue_depth != 0 ? queue_depth : 2 * num_threads + 1);
+    num_threads = std::min(num_threads, slots_.size());
+
+    try {
+      for (std::size_t i = 0; i < num_threads; ++i) {
+        threads_.emplace_back([this] { Work(); });
+      }
+    }
+    catch (...) {
+      Stop();
+      throw;
+    }
+  }
+
+  BtcK_ChainCursor(BtcK_ChainCursor const&) = delete;
+  auto operator=(BtcK_ChainCursor const&) -> BtcK_ChainCursor& = delete;
+  ~BtcK_ChainCursor() { Stop(); }
+
+  // Returns the next block, or null past the end of the range. A block that
+  // fails to read throws here, in its place in the sequence.
+  auto Next() -> CBlockRef
+  {
+    if (delivered_ == entries_.size()) {
+      return nullptr;
+    }
+
+    auto slot = Slot{};
+    {
+      auto lock = std::unique_lock{mutex_};
+      auto& next = slots_[delivered_ % slots_.size()];
+      ready_.wait(lock, [&] { return next.has_value(); });
+      slot = *std::move(next);
+      next.reset();
+      bytes_ -= slot.bytes;
+      ++delivered_;
+    }
+    claimable_.notify_all();
+
+    if (slot.exception) {
+      std::rethrow_exception(slot.exception);
+    }
+    return std::move(slot.block);
+  }
+
+private:
+  struct Slot {
+    CBlockRef block;
+    std::size_t bytes = 0;
+    std::exception_ptr exception;
+  };
+
+  void Work()
+  {
+    while (true) {
+      auto idx = std::size_t{0};
+      auto reserved = std::size_t{0};
+      {
+        auto lock = std::unique_lock{mutex_};
+        claimable_.wait(lock, [&] {
+          return stop_ || claimed_ == entries_.size() ||
+                 (claimed_ < delivered_ + slots_.size() &&
+                  (bytes_ < max_bytes_ || claimed_ == delivered_));
+        });
+        if (stop_ || claimed_ == entries_.size()) {
+          return;
+        }
+        idx = claimed_++;
+        reserved = read_count_ != 0 ? read_bytes_ / read_count_ : 0;
+        bytes_ += reserved;
+      }
+
+      auto slot = Slot{};
+      try {
+        slot.block = chain_.LoadBlock(entries_[idx]);
+        slot.bytes = util::DynamicMemoryUsage(slot.block);
+      }
+      catch (...) {
+        slot.exception = std::current_exception();
+      }
+
+      {
+        auto const lock = std::lock_guard{mutex_};
+        bytes_ = bytes_ - reserved + slot.bytes;
+        read_bytes_ += slot.bytes;
+        ++read_count_;
+        slots_[idx % slots_.size()] = std::move(slot);
+      }
+      ready_.notify_all();
+    }
+  }
+
+  void Stop() noexcept
+  {
+    {
+      auto const lock = std::lock_guard{mutex_};
+      stop_ = true;
+    }
+    claimable_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+    threads_.clear();
+  }
+
+  BtcK_Chain const& chain_;
+  std::vector<util::ChainEntry> const entries_;
+  std::size_t const max_bytes_;
+  std::vector<std::optional<Slot>> slots_;
+  std::vector<std::thread> threads_;
+
+  std::mutex mutex_;
+  std::condition_variable claimable_;
+  std::condition_variable ready_;
+  std::size_t claimed_ = 0;
+  std::size_t delivered_ = 0;
+  std::size_t bytes_ = 0;
+  std::size_t read_bytes_ = 0;
+  std::size_t read_count_ = 0;
+  bool stop_ = false;
+};
+
+extern "C" {
+
+auto BtcK_ChainCursor_New(
+  BtcK_Chain const* chain, std::size_t first, std::size_t last,
+  std::size_t queue_depth, std::size_t max_bytes, std::size_t num_threads,
+  struct BtcK_Error** err) -> BtcK_ChainCursor*
+{
+  return util::WrapFn(err, [=] {
+    return new BtcK_ChainCursor{
+      *chain, chain->ResolveRange(first, last), queue_depth, max_bytes,
+      num_threads};
+  });
+}
+
+void BtcK_ChainCursor_Free(BtcK_ChainCursor* self)
+{
+  delete self;
+}
+
+auto BtcK_ChainCursor_Next(BtcK_ChainCursor* self, struct BtcK_Error** err)
+  -> BtcK_Block*
+{
+  return util::WrapFn(err, [self]() -> BtcK_Block* {
+    auto block = self->Next();
+    if (block == nullptr) {
+      return nullptr;
+    }
+    return api::create<CBlockRef>(std::move(block));
+  });
+}
+
+}  // extern "C"
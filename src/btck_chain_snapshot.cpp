@@ -0,0 +1,75 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <btck/btck.h>  // IWYU pragma: associated
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <span>
+
+#include "chain.hpp"
+#include "uint256.h"
+#include "util/api.hpp"
+#include "util/chain_snapshot.hpp"
+#include "util/error.hpp"
+
+// The active chain as of one tip change. All calls on the same snapshot see
+// the same blocks, however the chain moves on in the meantime.
+struct BtcK_ChainSnapshot {
+  BtcK_Chain const& chain;
+  std::shared_ptr<util::ChainSnapshot const> snapshot;
+};
+
+extern "C" {
+
+auto BtcK_ChainSnapshot_New(BtcK_Chain const* chain, struct BtcK_Error** err)
+  -> BtcK_ChainSnapshot*
+{
+  return util::WrapFn(err, [chain] {
+    return new BtcK_ChainSnapshot{*chain, chain->Snapshot()};
+  });
+}
+
+void BtcK_ChainSnapshot_Free(BtcK_ChainSnapshot* self)
+{
+  delete self;
+}
+
+auto BtcK_ChainSnapshot_CountBlocks(BtcK_ChainSnapshot const* self)
+  -> std::size_t
+{
+  return self->snapshot->Size();
+}
+
+auto BtcK_ChainSnapshot_GetBlock(
+  BtcK_ChainSnapshot const* self, std::size_t height, struct BtcK_Error** err)
+  -> BtcK_Block*
+{
+  return util::WrapFn(err, [self, height] {
+    auto const& entry = self->snapshot->At(height);
+    return api::create<CBlockRef>(self->chain.ReadBlock(entry));
+  });
+}
+
+auto BtcK_ChainSnapshot_GetBlockHash(
+  BtcK_ChainSnapshot const* self, std::size_t height, BtcK_BlockHash* out,
+  struct BtcK_Error** err) -> int
+{
+  auto const ok = util::WrapFn(err, [=] {
+    auto const hash = self->snapshot->At(height).index->GetBlockHash();
+    std::ranges::copy(hash, out->data);
+    return true;
+  });
+  return ok ? 0 : -1;
+}
+
+auto BtcK_ChainSnapshot_FindBlock(
+  BtcK_ChainSnapshot const* self, BtcK_BlockHash const* block_hash)
+  -> std::ptrdiff_t
+{
+  return self->snapshot->Find(uint256{std::span{block_hash->data}});
+}
+
+}  // extern "C"
@@ -0,0 +1,461 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <btck/btck.h>  // IWYU pragma: associated
+
+#include <memusage.h>
+#include <streams.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "primitives/block.h"
+#include "primitives/transaction.h"
+#include "serialize.h"
+#include "uint256.h"
+#include "util/alloc.h"
+#include "util/api.hpp"
+#include "util/error.hpp"
+#include "util/memory_stats.hpp"
+
+namespace {
+
+struct TransactionRecord {
+  std::uint32_t first_input;
+  std::uint32_t first_output;
+  std::uint32_t version;
+  std::uint32_t lock_time;
+};
+
+struct InputRecord {
+  std::array<unsigned char, uint256::size()> prevout_hash;
+  std::uint32_t prevout_index;
+  std::uint32_t sequence;
+  std::uint32_t script_offset;
+  std::uint32_t script_size;
+  std::uint32_t first_witness_item;
+  std::uint32_t num_witness_items;
+};
+
+struct WitnessItemRecord {
+  std::uint32_t offset;
+  std::uint32_t size;
+};
+
+struct OutputRecord {
+  std::int64_t amount;
+  std::uint32_t script_offset;
+  std::uint32_t script_size;
+};
+
+auto CheckedSize(std::size_t size) -> std::uint32_t
+{
+  if (size > std::numeric_limits<std::uint32_t>::max()) {
+    throw std::length_error("Block too large.");
+  }
+  return static_cast<std::uint32_t>(size);
+}
+
+}  // namespace
+
+// A decoded block in a single allocation: this header, one record per
+// transaction plus a sentinel, the input records, the output records, the
+// witness item records and finally a script pool that the records refer to by
+// offset. The pool holds all scriptPubKeys first, so walking the outputs of a
+// block reads memory front to back, followed by the scriptSigs and the witness
+// items. Nothing of the block is dropped, so it can be rebuilt from this.
+struct alignas(OutputRecord) BtcK_FlatBlock {
+  BtcK_BlockHash hash;
+  CBlockHeader header;
+  std::uint32_t num_transactions;
+  std::uint32_t num_inputs;
+  std::uint32_t num_outputs;
+  std::uint32_t num_witness_items;
+  std::uint32_t script_size;
+
+  [[nodiscard]] auto InputsOffset() const -> std::size_t
+  {
+    return sizeof(BtcK_FlatBlock) +
+           (std::size_t{num_transactions} + 1) * sizeof(TransactionRecord);
+  }
+
+  [[nodiscard]] auto OutputsOffset() const -> std::size_t
+  {
+    return InputsOffset() + std::size_t{num_inputs} * sizeof(InputRecord);
+  }
+
+  [[nodiscard]] auto WitnessItemsOffset() const -> std::size_t
+  {
+    return OutputsOffset() + std::size_t{num_outputs} * sizeof(OutputRecord);
+  }
+
+  [[nodiscard]] auto ScriptsOffset() const -> std::size_t
+  {
+    return WitnessItemsOffset() +
+           std::size_t{num_witness_items} * sizeof(WitnessItemRecord);
+  }
+
+  [[nodiscard]] auto Size() const -> std::size_t
+  {
+    return ScriptsOffset() + script_size;
+  }
+
+  template <typename T> [[nodiscard]] auto At(std::size_t offset) -> T*
+  {
+    return reinterpret_cast<T*>(reinterpret_cast<std::byte*>(this) + offset);
+  }
+
+  template <typename T>
+  [[nodiscard]] auto At(std::size_t offset) const -> T const*
+  {
+    return reinterpret_cast<T const*>(
+      reinterpret_cast<std::byte const*>(this) + offset);
+  }
+
+  [[nodiscard]] auto Transactions() const -> TransactionRecord const*
+  {
+    return At<TransactionRecord>(sizeof(BtcK_FlatBlock));
+  }
+
+  [[nodiscard]] auto Inputs() const -> InputRecord const*
+  {
+    return At<InputRecord>(InputsOffset());
+  }
+
+  [[nodiscard]] auto Outputs() const -> OutputRecord const*
+  {
+    return At<OutputRecord>(OutputsOffset());
+  }
+
+  [[nodiscard]] auto WitnessItems() const -> WitnessItemRecord const*
+  {
+    return At<WitnessItemRecord>(WitnessItemsOffset());
+  }
+
+  [[nodiscard]] auto Script(std::uint32_t offset) const -> std::uint8_t const*
+  {
+    return At<std::uint8_t>(ScriptsOffset() + offset);
+  }
+};
+
+static_assert(std::is_trivially_destructible_v<BtcK_FlatBlock>);
+static_assert(std::is_trivially_copyable_v<BtcK_FlatBlock>);
+static_assert(sizeof(BtcK_FlatBlock) % alignof(OutputRecord) == 0);
+static_assert(sizeof(TransactionRecord) % alignof(OutputRecord) == 0);
+static_assert(sizeof(InputRecord) % alignof(OutputRecord) == 0);
+static_assert(alignof(WitnessItemRecord) <= alignof(OutputRecord));
+
+namespace {
+
+auto Allocate(std::size_t size) -> void*
+{
+  auto* storage = util_malloc(size);
+  if (storage == nullptr) {
+    throw std::bad_alloc();
+  }
+  util::MemoryStats::Add(
+    BtcK_ObjectType_FLAT_BLOCK, memusage::MallocUsage(size));
+  return storage;
+}
+
+auto Flatten(CBlock const& block) -> BtcK_FlatBlock*
+{
+  auto num_inputs = std::size_t{0};
+  auto num_outputs = std::size_t{0};
+  auto num_witness_items = std::size_t{0};
+  auto input_scripts = std::size_t{0};
+  auto output_scripts = std::size_t{0};
+  auto witness_size = std::size_t{0};
+  for (auto const& tx : block.vtx) {
+    num_inputs += tx->vin.size();
+    num_outputs += tx->vout.size();
+    for (auto const& txin : tx->vin) {
+      input_scripts += txin.scriptSig.size();
+      num_witness_items += txin.scriptWitness.stack.size();
+      for (auto const& item : txin.scriptWitness.stack) {
+        witness_size += item.size();
+      }
+    }
+    for (auto const& txout : tx->vout) {
+      output_scripts += txout.scriptPubKey.size();
+    }
+  }
+
+  auto header = BtcK_FlatBlock{
+    .hash = {},
+    .header = block.GetBlockHeader(),
+    .num_transactions = CheckedSize(block.vtx.size()),
+    .num_inputs = CheckedSize(num_inputs),
+    .num_outputs = CheckedSize(num_outputs),
+    .num_witness_items = CheckedSize(num_witness_items),
+    .script_size =
+      CheckedSize(output_scripts + input_scripts + witness_size),
+  };
+  auto const hash = block.GetHash();
+  std::copy(hash.begin(), hash.end(), header.hash.data);
+
+  auto* self = ::new (Allocate(header.Size())) BtcK_FlatBlock{header};
+  auto* txs = self->At<TransactionRecord>(sizeof(BtcK_FlatBlock));
+  auto* inputs = self->At<InputRecord>(self->InputsOffset());
+  auto* outputs = self->At<OutputRecord>(self->OutputsOffset());
+  auto* items = self->At<WitnessItemRecord>(self->WitnessItemsOffset());
+  auto* scripts = self->At<std::uint8_t>(self->ScriptsOffset());
+
+  auto const append = [scripts](auto const& script, std::uint32_t& offset) {
+    std::copy(script.begin(), script.end(), scripts + offset);
+    offset += static_cast<std::uint32_t>(script.size());
+  };
+
+  auto input_idx = std::uint32_t{0};
+  auto output_idx = std::uint32_t{0};
+  auto item_idx = std::uint32_t{0};
+  auto output_script = std::uint32_t{0};
+  auto input_script = static_cast<std::uint32_t>(output_scripts);
+  auto witness_item =
+    static_cast<std::uint32_t>(output_scripts + input_scripts);
+  for (auto const& tx : block.vtx) {
+    *txs++ =
+      TransactionRecord{input_idx, output_idx, tx->version, tx->nLockTime};
+    for (auto const& txin : tx->vin) {
+      auto& record = inputs[input_idx++];
+      auto const& prevout_hash = txin.prevout.hash.ToUint256();
+      std::copy(
+        prevout_hash.begin(), prevout_hash.end(), record.prevout_hash.begin());
+      record.prevout_index = txin.prevout.n;
+      record.sequence = txin.nSequence;
+      record.script_offset = input_script;
+      record.script_size = static_cast<std::uint32_t>(txin.scriptSig.size());
+      append(txin.scriptSig, input_script);
+      auto const& stack = txin.scriptWitness.stack;
+      record.first_witness_item = item_idx;
+      record.num_witness_items = static_cast<std::uint32_t>(stack.size());
+      for (auto const& item : stack) {
+        items[item_idx++] = WitnessItemRecord{
+          witness_item, static_cast<std::uint32_t>(item.size())};
+        append(item, witness_item);
+      }
+    }
+    for (auto const& txout : tx->vout) {
+      auto& record = outputs[output_idx++];
+      record.amount = txout.nValue;
+      record.script_offset = output_script;
+      record.script_size =
+        static_cast<std::uint32_t>(txout.scriptPubKey.size());
+      append(txout.scriptPubKey, output_script);
+    }
+  }
+  *txs = TransactionRecord{input_idx, output_idx, 0, 0};
+  return self;
+}
+
+auto Unflatten(BtcK_FlatBlock const& self) -> CBlock
+{
+  auto block = CBlock{self.header};
+  block.vtx.reserve(self.num_transactions);
+  auto const* txs = self.Transactions();
+  for (std::uint32_t tx_idx = 0; tx_idx < self.num_transactions; ++tx_idx) {
+    auto const& record = txs[tx_idx];
+    auto const& next = txs[tx_idx + 1];
+    auto tx = CMutableTransaction{};
+    tx.version = record.version;
+    tx.nLockTime = record.lock_time;
+
+    tx.vin.reserve(next.first_input - record.first_input);
+    for (auto idx = record.first_input; idx < next.first_input; ++idx) {
+      auto const& input = self.Inputs()[idx];
+      auto& txin = tx.vin.emplace_back();
+      txin.prevout = COutPoint{
+        Txid::FromUint256(uint256{input.prevout_hash}), input.prevout_index};
+      txin.nSequence = input.sequence;
+      auto const* script = self.Script(input.script_offset);
+      txin.scriptSig = CScript(script, script + input.script_size);
+      auto& stack = txin.scriptWitness.stack;
+      stack.reserve(input.num_witness_items);
+      for (std::uint32_t i = 0; i < input.num_witness_items; ++i) {
+        auto const& item = self.WitnessItems()[input.first_witness_item + i];
+        auto const* data = self.Script(item.offset);
+        stack.emplace_back(data, data + item.size);
+      }
+    }
+
+    tx.vout.reserve(next.first_output - record.first_output);
+    for (auto idx = record.first_output; idx < next.first_output; ++idx) {
+      auto const& output = self.Outputs()[idx];
+      auto const* script = self.Script(output.script_offset);
+      tx.vout.emplace_back(
+        output.amount, CScript(script, script + output.script_size));
+    }
+
+    block.vtx.push_back(MakeTransactionRef(std::move(tx)));
+  }
+  return block;
+}
+
+}  // namespace
+
+extern "C" {
+
+auto BtcK_FlatBlock_New(
+  void const* raw, std::size_t len, struct BtcK_Error** err) -> BtcK_FlatBlock*
+{
+  return util::WrapFn(err, [raw, len] {
+    auto const data = std::span{reinterpret_cast<std::byte const*>(raw), len};
+    auto block = CBlock{};
+    auto stream = DataStream{data};
+    stream >> TX_WITH_WITNESS(block);
+    return Flatten(block);
+  });
+}
+
+auto BtcK_FlatBlock_FromBlock(BtcK_Block const* block, struct BtcK_Error** err)
+  -> BtcK_FlatBlock*
+{
+  return util::WrapFn(err, [block] { return Flatten(*api::get(block)); });
+}
+
+auto BtcK_FlatBlock_ToBlock(BtcK_FlatBlock const* self, struct BtcK_Error** err)
+  -> BtcK_Block*
+{
+  return util::WrapFn(err, [self] {
+    return api::create<CBlockRef>(util::MakeShared<CBlock>(Unflatten(*self)));
+  });
+}
+
+auto BtcK_FlatBlock_Copy(BtcK_FlatBlock const* self, struct BtcK_Error** err)
+  -> BtcK_FlatBlock*
+{
+  return util::WrapFn(err, [self] {
+    auto const size = self->Size();
+    return static_cast<BtcK_FlatBlock*>(
+      std::memcpy(Allocate(size), self, size));
+  });
+}
+
+void BtcK_FlatBlock_Free(BtcK_FlatBlock* self)
+{
+  if (self == nullptr) {
+    return;
+  }
+  util::MemoryStats::Remove(
+    BtcK_ObjectType_FLAT_BLOCK, BtcK_FlatBlock_DynamicMemoryUsage(self));
+  util_free(self);
+}
+
+auto BtcK_FlatBlock_DynamicMemoryUsage(BtcK_FlatBlock const* self)
+  -> std::size_t
+{
+  return memusage::MallocUsage(self->Size());
+}
+
+void BtcK_FlatBlock_GetHash(BtcK_FlatBlock const* self, BtcK_BlockHash* out)
+{
+  *out = self->hash;
+}
+
+auto BtcK_FlatBlock_CountTransactions(BtcK_FlatBlock const* self)
+  -> std::size_t
+{
+  return self->num_transactions;
+}
+
+auto BtcK_FlatBlock_CountInputs(BtcK_FlatBlock const* self) -> std::size_t
+{
+  return self->num_inputs;
+}
+
+auto BtcK_FlatBlock_CountOutputs(BtcK_FlatBlock const* self) -> std::size_t
+{
+  return self->num_outputs;
+}
+
+auto BtcK_FlatBlock_GetTransactionVersion(
+  BtcK_FlatBlock const* self, std::size_t tx_idx) -> std::uint32_t
+{
+  return self->Transactions()[tx_idx].version;
+}
+
+auto BtcK_FlatBlock_GetTransactionLockTime(
+  BtcK_FlatBlock const* self, std::size_t tx_idx) -> std::uint32_t
+{
+  return self->Transactions()[tx_idx].lock_time;
+}
+
+auto BtcK_FlatBlock_GetFirstInput(
+  BtcK_FlatBlock const* self, std::size_t tx_idx) -> std::size_t
+{
+  return self->Transactions()[tx_idx].first_input;
+}
+
+auto BtcK_FlatBlock_GetFirstOutput(
+  BtcK_FlatBlock const* self, std::size_t tx_idx) -> std::size_t
+{
+  return self->Transactions()[tx_idx].first_output;
+}
+
+void BtcK_FlatBlock_GetInputPrevout(
+  BtcK_FlatBlock const* self, std::size_t idx, unsigned char* txid,
+  std::uint32_t* vout)
+{
+  auto const& record = self->Inputs()[idx];
+  std::ranges::copy(record.prevout_hash, txid);
+  *vout = record.prevout_index;
+}
+
+auto BtcK_FlatBlock_GetInputSequence(
+  BtcK_FlatBlock const* self, std::size_t idx) -> std::uint32_t
+{
+  return self->Inputs()[idx].sequence;
+}
+
+auto BtcK_FlatBlock_GetInputScriptSig(
+  BtcK_FlatBlock const* self, std::size_t idx, std::size_t* len)
+  -> std::uint8_t const*
+{
+  auto const& record = self->Inputs()[idx];
+  *len = record.script_size;
+  return self->Script(record.script_offset);
+}
+
+auto BtcK_FlatBlock_CountInputWitnessItems(
+  BtcK_FlatBlock const* self, std::size_t idx) -> std::size_t
+{
+  return self->Inputs()[idx].num_witness_items;
+}
+
+auto BtcK_FlatBlock_GetInputWitnessItem(
+  BtcK_FlatBlock const* self, std::size_t idx, std::size_t item_idx,
+  std::size_t* len) -> std::uint8_t const*
+{
+  auto const& input = self->Inputs()[idx];
+  auto const& item = self->WitnessItems()[input.first_witness_item + item_idx];
+  *len = item.size;
+  return self->Script(item.offset);
+}
+
+auto BtcK_FlatBlock_GetOutputAmount(
+  BtcK_FlatBlock const* self, std::size_t idx) -> std::int64_t
+{
+  return self->Outputs()[idx].amount;
+}
+
+auto BtcK_FlatBlock_GetOutputScriptPubkey(
+  BtcK_FlatBlock const* self, std::size_t idx, std::size_t* len)
+  -> std::uint8_t const*
+{
+  auto const& record = self->Outputs()[idx];
+  *len = record.script_size;
+  return self->Script(record.script_offset);
+}
+
+}  // extern "C"
@@ -0,0 +1,131 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <btck/btck.h>  // IWYU pragma: associated
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "chain.hpp"
+#include "flatfile.h"
+#include "util/error.hpp"
+
+// The serialized bytes of a block as stored in the block files. Without
+// obfuscation the bytes are mapped from the file and never copied, otherwise
+// they are read and deobfuscated into a buffer.
+struct BtcK_RawBlock {
+  BtcK_RawBlock() = default;
+  BtcK_RawBlock(BtcK_RawBlock const&) = delete;
+  auto operator=(BtcK_RawBlock const&) -> BtcK_RawBlock& = delete;
+
+  ~BtcK_RawBlock()
+  {
+#ifndef _WIN32
+    if (mapping != nullptr) {
+      munmap(mapping, mapping_size);
+    }
+#endif
+  }
+
+  std::span<std::uint8_t const> bytes;
+  std::vector<std::uint8_t> buffer;
+  void* mapping = nullptr;
+  std::size_t mapping_size = 0;
+};
+
+namespace {
+
+#ifndef _WIN32
+
+[[noreturn]] void ThrowErrno()
+{
+  throw std::system_error(errno, std::generic_category());
+}
+
+// Maps the block at `pos` through the pooled file descriptor, after checking
+// the network magic and size that precede it in the file.
+void Map(BtcK_RawBlock& self, BtcK_Chain const& chain, FlatFilePos const& pos)
+{
+  auto const file = chain.block_files.Open(pos.nFile);
+  auto const size = chain.block_files.BlockSize(*file, pos);
+
+  if (file->Size() < pos.nPos + size) {
+    throw std::runtime_error("Block file truncated.");
+  }
+
+  auto const page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  auto const offset = pos.nPos - pos.nPos % page_size;
+  auto const length = pos.nPos - offset + size;
+  auto* mapping = mmap(
+    nullptr, length, PROT_READ, MAP_PRIVATE, file->get(),
+    static_cast<off_t>(offset));
+  if (mapping == MAP_FAILED) {
+    ThrowErrno();
+  }
+  self.mapping = mapping;
+  self.mapping_size = length;
+  self.bytes = {
+    static_cast<std::uint8_t const*>(mapping) + (pos.nPos - offset), size};
+}
+
+#endif
+
+void Read(BtcK_RawBlock& self, BtcK_Chain const& chain, FlatFilePos const& pos)
+{
+  chain.ReadRawBlock(pos, self.buffer);
+  self.bytes = self.buffer;
+}
+
+}  // namespace
+
+extern "C" {
+
+auto BtcK_RawBlock_New(
+  BtcK_Chain const* chain, std::size_t height, struct BtcK_Error** err)
+  -> BtcK_RawBlock*
+{
+  return util::WrapFn(err, [=] {
+    auto const pos = chain->BlockPos(height);
+    auto self = std::make_unique<BtcK_RawBlock>();
+#ifndef _WIN32
+    if (!chain->block_files.Obfuscated()) {
+      Map(*self, *chain, pos);
+      return self.release();
+    }
+#endif
+    Read(*self, *chain, pos);
+    return self.release();
+  });
+}
+
+void BtcK_RawBlock_Free(BtcK_RawBlock* self)
+{
+  delete self;
+}
+
+auto BtcK_RawBlock_GetBytes(BtcK_RawBlock const* self, std::size_t* len)
+  -> void const*
+{
+  *len = self->bytes.size();
+  return self->bytes.data();
+}
+
+auto BtcK_RawBlock_IsMapped(BtcK_RawBlock const* self) -> int
+{
+  return self->mapping != nullptr ? 1 : 0;
+}
+
+}  // extern "C"
@@ -18,6 +18,10 @@
 #include "script/script.h"
 #include "util/api.hpp"
 #include "util/error.hpp"
+#include "util/intern_table.hpp"
+#include "util/memory_stats.hpp"
+#include "util/output.hpp"
+#include "util/verify.hpp"
 
 namespace {
 
@@ -26,20 +30,10 @@ auto verify(
   CTransaction const& tx, std::vector<CTxOut> spent_outputs,
   unsigned int const input_index, BtcK_VerificationFlags flags)
 {
-  if ((flags & ~BtcK_VerificationFlags_ALL) != 0) {
-    throw std::system_error(btck::verification_error::invalid_flags);
-  }
+  util::CheckVerificationFlags(flags);
 
-  bool const cleanstack = (flags & SCRIPT_VERIFY_CLEANSTACK) != 0;
-  bool const p2sh = (flags & SCRIPT_VERIFY_P2SH) != 0;
-  bool const witness = (flags & SCRIPT_VERIFY_WITNESS) != 0;
   bool const taproot = (flags & SCRIPT_VERIFY_TAPROOT) != 0;
 
-  if ((cleanstack && !p2sh && !witness) || (witness && !p2sh)) {
-    throw std::system_error(
-      btck::verification_error::invalid_flags_combination);
-  }
-
   if (taproot && spent_outputs.empty()) {
     throw std::system_error(btck::verification_error::spent_outputs_required);
   }
@@ -74,9 +68,16 @@ auto BtcK_ScriptPubkey_New(
   void const* raw, std::size_t len, struct BtcK_Error** err)
   -> BtcK_ScriptPubkey*
 {
-  return util::WrapFn(err, [raw, len] {
+  return BtcK_ScriptPubkey_NewIn(nullptr, raw, len, err);
+}
+
+auto BtcK_ScriptPubkey_NewIn(
+  BtcK_Arena* arena, void const* raw, std::size_t len, struct BtcK_Error** err)
+  -> BtcK_ScriptPubkey*
+{
+  return util::WrapFn(err, [arena, raw, len] {
     auto data = std::span{reinterpret_cast<std::uint8_t const*>(raw), len};
-    return api::create<CScript>(data.begin(), data.end());
+    return api::create_in<CScript>(arena, data.begin(), data.end());
   });
 }
 
@@ -86,14 +87,79 @@ auto BtcK_ScriptPubkey_Copy(
   return api::copy(self, err);
 }
 
+auto BtcK_ScriptPubkey_CopyIn(
+  BtcK_Arena* arena, BtcK_ScriptPubkey const* self, struct BtcK_Error** err)
+  -> BtcK_ScriptPubkey*
+{
+  return api::copy_in(arena, self, err);
+}
+
 void BtcK_ScriptPubkey_Free(BtcK_ScriptPubkey* self)
 {
   api::free(self);
 }
 
+auto BtcK_ScriptPubkey_SizeOf() -> std::size_t
+{
+  return sizeof(CScript);
+}
+
+auto BtcK_ScriptPubkey_AlignOf() -> std::size_t
+{
+  return alignof(CScript);
+}
+
+auto BtcK_ScriptPubkey_InitAt(
+  void* storage, void const* raw, std::size_t len, struct BtcK_Error** err)
+  -> BtcK_ScriptPubkey*
+{
+  return util::WrapFn(err, [storage, raw, len] {
+    auto data = std::span{reinterpret_cast<std::uint8_t const*>(raw), len};
+    return api::create_at<CScript>(storage, data.begin(), data.end());
+  });
+}
+
+auto BtcK_ScriptPubkey_CopyAt(
+  void* storage, BtcK_ScriptPubkey const* self, struct BtcK_Error** err)
+  -> BtcK_ScriptPubkey*
+{
+  return api::copy_at(storage, self, err);
+}
+
+void BtcK_ScriptPubkey_Destroy(BtcK_ScriptPubkey* self)
+{
+  api::destroy(self);
+}
+
+auto BtcK_ScriptPubkey_Intern(
+  BtcK_ScriptPubkey const* self, struct BtcK_Error** err)
+  -> BtcK_ScriptPubkey const*
+{
+  return util::WrapFn(err, [self] {
+    return api::ref(util::InternTable::Get().Intern(api::get(self)));
+  });
+}
+
+void BtcK_ScriptPubkey_Release(BtcK_ScriptPubkey const* self)
+{
+  if (self == nullptr) {
+    return;
+  }
+  util::InternTable::Get().Release(api::get(self));
+}
+
+auto BtcK_ScriptPubkey_DynamicMemoryUsage(BtcK_ScriptPubkey const* self)
+  -> std::size_t
+{
+  return util::DynamicMemoryUsage(api::get(self));
+}
+
 auto BtcK_ScriptPubkey_Equal(
   BtcK_ScriptPubkey const* left, BtcK_ScriptPubkey const* right) -> int
 {
+  if (left == right) {
+    return 1;
+  }
   return (api::get(left) == api::get(right)) ? 1 : 0;
 }
 
@@ -115,7 +181,8 @@ auto BtcK_ScriptPubkey_Verify(
   return util::WrapFn(err, [=] {
     auto const spent_outputs_view =
       std::span{spent_outputs, spent_outputs_len} |
-      std::views::transform([](auto const* out) { return api::get(out); });
+      std::views::transform(
+        [](auto const* out) { return util::OutputRef{out}.ToTxOut(); });
     auto const result = verify(
       api::get(script_pubkey), amount, *api::get(tx),
       std::vector(spent_outputs_view.begin(), spent_outputs_view.end()),
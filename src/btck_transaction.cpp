@@ -18,20 +18,37 @@
 #include "span.h"
 #include "util/api.hpp"
 #include "util/error.hpp"
+#include "util/json.hpp"
+#include "util/memory_stats.hpp"
+#include "util/output.hpp"
 #include "util/writer_stream.hpp"
 
+namespace {
+
+auto Parse(void const* raw, std::size_t len) -> CTransactionRef
+{
+  auto const bytes = std::span{reinterpret_cast<std::byte const*>(raw), len};
+  auto stream = DataStream{bytes};
+  return util::MakeShared<CTransaction>(deserialize, TX_WITH_WITNESS, stream);
+}
+
+}  // namespace
+
 extern "C" {
 
 auto BtcK_Transaction_New(
   void const* raw, std::size_t len, struct BtcK_Error** err)
   -> BtcK_Transaction*
 {
-  return util::WrapFn(err, [raw, len] {
-    auto const bytes = std::span{reinterpret_cast<std::byte const*>(raw), len};
-    auto stream = DataStream{bytes};
-    auto tx =
-      std::make_shared<CTransaction>(deserialize, TX_WITH_WITNESS, stream);
-    return api::create<CTransactionRef>(std::move(tx));
+  return BtcK_Transaction_NewIn(nullptr, raw, len, err);
+}
+
+auto BtcK_Transaction_NewIn(
+  BtcK_Arena* arena, void const* raw, std::size_t len, struct BtcK_Error** err)
+  -> BtcK_Transaction*
+{
+  return util::WrapFn(err, [arena, raw, len] {
+    return api::create_in<CTransactionRef>(arena, Parse(raw, len));
   });
 }
 
@@ -41,11 +58,55 @@ auto BtcK_Transaction_Copy(
   return api::copy(self, err);
 }
 
+auto BtcK_Transaction_CopyIn(
+  BtcK_Arena* arena, BtcK_Transaction const* self, struct BtcK_Error** err)
+  -> BtcK_Transaction*
+{
+  return api::copy_in(arena, self, err);
+}
+
 void BtcK_Transaction_Free(BtcK_Transaction* self)
 {
   api::free(self);
 }
 
+auto BtcK_Transaction_SizeOf() -> std::size_t
+{
+  return sizeof(CTransactionRef);
+}
+
+auto BtcK_Transaction_AlignOf() -> std::size_t
+{
+  return alignof(CTransactionRef);
+}
+
+auto BtcK_Transaction_InitAt(
+  void* storage, void const* raw, std::size_t len, struct BtcK_Error** err)
+  -> BtcK_Transaction*
+{
+  return util::WrapFn(err, [storage, raw, len] {
+    return api::create_at<CTransactionRef>(storage, Parse(raw, len));
+  });
+}
+
+auto BtcK_Transaction_CopyAt(
+  void* storage, BtcK_Transaction const* self, struct BtcK_Error** err)
+  -> BtcK_Transaction*
+{
+  return api::copy_at(storage, self, err);
+}
+
+void BtcK_Transaction_Destroy(BtcK_Transaction* self)
+{
+  api::destroy(self);
+}
+
+auto BtcK_Transaction_DynamicMemoryUsage(BtcK_Transaction const* self)
+  -> std::size_t
+{
+  return util::DynamicMemoryUsage(api::get(self));
+}
+
 auto BtcK_Transaction_CountOutputs(BtcK_Transaction const* self) -> std::size_t
 {
   return api::get(self)->vout.size();
@@ -57,6 +118,19 @@ auto BtcK_Transaction_GetOutput(BtcK_Transaction const* self, std::size_t idx)
   return api::ref(api::get(self)->vout[idx]);
 }
 
+auto BtcK_Transaction_GetOutputRef(
+  BtcK_Transaction const* self, std::size_t idx, struct BtcK_Error** err)
+  -> BtcK_TransactionOutput*
+{
+  return util::WrapFn(err, [self, idx] {
+    auto const& tx = api::get(self);
+    auto const& txout = tx->vout.at(idx);
+    // Aliases the script, so the output keeps the transaction alive.
+    return util::OutputRef::Tag(api::create<util::SharedOutput>(
+      txout.nValue, std::shared_ptr<CScript const>{tx, &txout.scriptPubKey}));
+  });
+}
+
 auto BtcK_Transaction_ToBytes(
   BtcK_Transaction const* self, BtcK_WriteBytes write, void* userdata) -> int
 {
@@ -78,4 +152,23 @@ auto BtcK_Transaction_ToString(
   return static_cast<int>(str.size());
 }
 
+auto BtcK_Transaction_ToJson(
+  BtcK_Transaction const* self, BtcK_WriteBytes write, void* userdata,
+  BtcK_JsonOptions options) -> int
+{
+  if ((options & ~BtcK_JsonOptions_ALL) != 0) {
+    return -1;
+  }
+
+  try {
+    auto json = util::JsonWriter{write, userdata};
+    util::WriteTransactionJson(json, *api::get(self), options);
+    json.Flush();
+    return 0;
+  }
+  catch (...) {
+    return -1;
+  }
+}
+
 }  // extern "C"
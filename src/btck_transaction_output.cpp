@@ -3,25 +3,89 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <btck/btck.h>  // IWYU pragma: associated
+#include <consensus/amount.h>
 
+#include <compressor.h>
+#include <serialize.h>
+
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <utility>
 
 #include "primitives/transaction.h"
 #include "util/api.hpp"
 #include "util/error.hpp"
+#include "util/intern_table.hpp"
+#include "util/memory_stats.hpp"
+#include "util/output.hpp"
+#include "util/reader_stream.hpp"
+#include "util/writer_stream.hpp"
 
 struct BtcK_Error;
 
+namespace {
+
+void Compress(util::WriterStream& stream, util::OutputRef const output)
+{
+  // The amount compression is only reversible for valid amounts.
+  auto const amount = output.Amount();
+  if (!MoneyRange(amount)) {
+    throw std::out_of_range("Amount out of range.");
+  }
+  stream << Using<AmountCompression>(amount)
+         << Using<ScriptCompression>(output.Script());
+}
+
+auto Decompress(util::ReaderStream& stream) -> CTxOut
+{
+  auto txout = CTxOut{};
+  stream >> Using<TxOutCompression>(txout);
+  return txout;
+}
+
+// Interned scripts are held by reference rather than copied.
+auto NewIn(BtcK_Arena* arena, CAmount amount, CScript const& script)
+  -> BtcK_TransactionOutput*
+{
+  if (auto shared = util::InternTable::Get().Share(script)) {
+    return util::OutputRef::Tag(
+      api::create_in<util::SharedOutput>(arena, amount, std::move(shared)));
+  }
+  return api::create_in<CTxOut>(arena, amount, script);
+}
+
+auto CopyIn(BtcK_Arena* arena, util::OutputRef const self)
+  -> BtcK_TransactionOutput*
+{
+  if (self.IsShared()) {
+    return util::OutputRef::Tag(
+      api::create_in<util::SharedOutput>(arena, self.Shared()));
+  }
+  return api::create_in<CTxOut>(arena, self.TxOut());
+}
+
+}  // namespace
+
 extern "C" {
 
 auto BtcK_TransactionOutput_New(
   int64_t amount, BtcK_ScriptPubkey const* script_pubkey, BtcK_Error** err)
   -> BtcK_TransactionOutput*
 {
-  return util::WrapFn(err, [amount, script_pubkey] {
-    return api::create<CTxOut>(amount, api::get(script_pubkey));
+  return BtcK_TransactionOutput_NewIn(nullptr, amount, script_pubkey, err);
+}
+
+auto BtcK_TransactionOutput_NewIn(
+  BtcK_Arena* arena, int64_t amount, BtcK_ScriptPubkey const* script_pubkey,
+  BtcK_Error** err) -> BtcK_TransactionOutput*
+{
+  return util::WrapFn(err, [arena, amount, script_pubkey] {
+    return NewIn(arena, amount, api::get(script_pubkey));
   });
 }
 
@@ -29,32 +93,185 @@ auto BtcK_TransactionOutput_Copy(
   BtcK_TransactionOutput const* self, BtcK_Error** err)
   -> BtcK_TransactionOutput*
 {
-  return api::copy(self, err);
+  return BtcK_TransactionOutput_CopyIn(nullptr, self, err);
+}
+
+auto BtcK_TransactionOutput_CopyIn(
+  BtcK_Arena* arena, BtcK_TransactionOutput const* self, BtcK_Error** err)
+  -> BtcK_TransactionOutput*
+{
+  return util::WrapFn(
+    err, [arena, self] { return CopyIn(arena, util::OutputRef{self}); });
 }
 
 void BtcK_TransactionOutput_Free(BtcK_TransactionOutput* self)
 {
-  api::free(self);
+  if (self == nullptr) {
+    return;
+  }
+  auto const output = util::OutputRef{self};
+  if (output.IsShared()) {
+    api::free_object(&output.Shared());
+  }
+  else {
+    api::free_object(&output.TxOut());
+  }
+}
+
+auto BtcK_TransactionOutput_SizeOf() -> std::size_t
+{
+  return std::max(sizeof(CTxOut), sizeof(util::SharedOutput));
+}
+
+auto BtcK_TransactionOutput_AlignOf() -> std::size_t
+{
+  return std::max(alignof(CTxOut), alignof(util::SharedOutput));
+}
+
+auto BtcK_TransactionOutput_InitAt(
+  void* storage, int64_t amount, BtcK_ScriptPubkey const* script_pubkey,
+  BtcK_Error** err) -> BtcK_TransactionOutput*
+{
+  return util::WrapFn(err, [storage, amount, script_pubkey] {
+    auto const& script = api::get(script_pubkey);
+    if (auto shared = util::InternTable::Get().Share(script)) {
+      return util::OutputRef::Tag(api::create_at<util::SharedOutput>(
+        storage, amount, std::move(shared)));
+    }
+    return api::create_at<CTxOut>(storage, amount, script);
+  });
+}
+
+auto BtcK_TransactionOutput_CopyAt(
+  void* storage, BtcK_TransactionOutput const* self, struct BtcK_Error** err)
+  -> BtcK_TransactionOutput*
+{
+  return util::WrapFn(err, [storage, self] {
+    auto const output = util::OutputRef{self};
+    if (output.IsShared()) {
+      return util::OutputRef::Tag(
+        api::create_at<util::SharedOutput>(storage, output.Shared()));
+    }
+    return api::create_at<CTxOut>(storage, output.TxOut());
+  });
+}
+
+void BtcK_TransactionOutput_Destroy(BtcK_TransactionOutput* self)
+{
+  if (self == nullptr) {
+    return;
+  }
+  auto const output = util::OutputRef{self};
+  if (output.IsShared()) {
+    api::destroy_object(&output.Shared());
+  }
+  else {
+    api::destroy_object(&output.TxOut());
+  }
+}
+
+auto BtcK_TransactionOutput_DynamicMemoryUsage(
+  BtcK_TransactionOutput const* self) -> std::size_t
+{
+  auto const output = util::OutputRef{self};
+  return output.IsShared() ? util::DynamicMemoryUsage(output.Shared())
+                           : util::DynamicMemoryUsage(output.TxOut());
 }
 
 auto BtcK_TransactionOutput_GetAmount(BtcK_TransactionOutput const* self)
   -> std::int64_t
 {
-  return api::get(self).nValue;
+  return util::OutputRef{self}.Amount();
 }
 
 auto BtcK_TransactionOutput_GetScriptPubkey(BtcK_TransactionOutput const* self)
   -> BtcK_ScriptPubkey const*
 {
-  return api::ref(api::get(self).scriptPubKey);
+  return api::ref(util::OutputRef{self}.Script());
 }
 
 auto BtcK_TransactionOutput_ToString(
   BtcK_TransactionOutput const* self, char* buf, size_t len) -> int
 {
-  auto const str = api::get(self).ToString();
+  auto const str = util::OutputRef{self}.ToTxOut().ToString();
   str.copy(buf, len);
   return static_cast<int>(str.size());
 }
 
+auto BtcK_TransactionOutput_Compress(
+  BtcK_TransactionOutput const* self, BtcK_WriteBytes write, void* userdata)
+  -> int
+{
+  try {
+    auto stream = util::WriterStream{write, userdata};
+    Compress(stream, util::OutputRef{self});
+    return 0;
+  }
+  catch (...) {
+    return -1;
+  }
+}
+
+auto BtcK_TransactionOutput_Decompress(
+  void const* raw, std::size_t len, BtcK_Error** err) -> BtcK_TransactionOutput*
+{
+  return util::WrapFn(err, [raw, len] {
+    auto stream = util::ReaderStream{
+      std::span{reinterpret_cast<std::byte const*>(raw), len}};
+    auto txout = Decompress(stream);
+    if (!stream.empty()) {
+      throw std::runtime_error("Trailing data after compressed output.");
+    }
+    return api::create<CTxOut>(std::move(txout));
+  });
+}
+
+auto BtcK_TransactionOutput_CompressMany(
+  BtcK_TransactionOutput const* const* outputs, std::size_t outputs_len,
+  BtcK_WriteBytes write, void* userdata) -> int
+{
+  try {
+    auto stream = util::WriterStream{write, userdata};
+    for (auto const* output : std::span{outputs, outputs_len}) {
+      Compress(stream, util::OutputRef{output});
+    }
+    return 0;
+  }
+  catch (...) {
+    return -1;
+  }
+}
+
+auto BtcK_TransactionOutput_DecompressMany(
+  void const* raw, std::size_t len, BtcK_TransactionOutput** outputs,
+  std::size_t outputs_len, std::size_t* consumed, BtcK_Error** err)
+  -> std::size_t
+{
+  // On failure no output is kept, so no input counts as consumed.
+  if (consumed != nullptr) {
+    *consumed = 0;
+  }
+  return util::WrapFn(err, [=] {
+    auto stream = util::ReaderStream{
+      std::span{reinterpret_cast<std::byte const*>(raw), len}};
+    auto count = std::size_t{0};
+    try {
+      for (; count < outputs_len && !stream.empty(); ++count) {
+        outputs[count] = api::create<CTxOut>(Decompress(stream));
+      }
+    }
+    catch (...) {
+      for (auto*& output : std::span{outputs, count}) {
+        BtcK_TransactionOutput_Free(std::exchange(output, nullptr));
+      }
+      throw;
+    }
+    // Input left over once the outputs are full is the caller's to continue.
+    if (consumed != nullptr) {
+      *consumed = len - stream.size();
+    }
+    return count;
+  });
+}
+
 }  // extern "C"
@@ -6,40 +6,497 @@
 
 #include <btck/btck.h>  // IWYU pragma: associated
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <span>
 #include <stdexcept>
+#include <string>
+#include <system_error>
+#include <tuple>
 #include <utility>
+#include <vector>
 
+#include "arith_uint256.h"
+#include "block_undo.hpp"
 #include "chain.h"
+#include "consensus/params.h"
+#include "consensus/validation.h"
+#include "dbwrapper.h"
+#include "flatfile.h"
+#include "kernel/caches.h"
+#include "kernel/checks.h"
 #include "node/blockstorage.h"
+#include "node/chainstate.h"
 #include "primitives/block.h"
+#include "serialize.h"
 #include "span.h"
+#include "streams.h"
+#include "sync.h"
 #include "uint256.h"
+#include "undo.h"
+#include "validation.h"
 #include "util/api.hpp"
+#include "util/block_files.hpp"
 #include "util/error.hpp"
+#include "util/export.hpp"
+#include "util/memory_stats.hpp"
+#include "util/fs.h"
+#include "util/result.h"
+#include "util/translation.h"
 
-//   // poor man's cpp support for named arguments
-//   struct KwArgs
-//   {
-//     KwArgs();
-//     auto chain_type(ChainType arg) && -> KwArgs;
-//     auto validation(Validation arg) && -> KwArgs;
+namespace {
 
-//     template <typename T>
-//     auto notifications(KernelNotifications<T> arg) && -> KwArgs;
+auto MakeChainParams(BtcK_ChainType chain_type)
+  -> std::unique_ptr<CChainParams const>
+{
+  switch (chain_type) {
+    case BtcK_ChainType_MAINNET:
+      return CChainParams::Main();
+    case BtcK_ChainType_TESTNET:
+      return CChainParams::TestNet();
+    case BtcK_ChainType_TESTNET_4:
+      return CChainParams::TestNet4();
+    case BtcK_ChainType_SIGNET:
+      return CChainParams::SigNet(CChainParams::SigNetOptions{});
+    case BtcK_ChainType_REGTEST:
+      return CChainParams::RegTest(CChainParams::RegTestOptions{});
+    default:
+      throw std::invalid_argument("Unknown chain type.");
+  }
+}
+
+auto DataDir(BtcK_ChainOptions const& options) -> fs::path
+{
+  if (options.data_dir == nullptr) {
+    throw std::invalid_argument("Missing data directory.");
+  }
+  return fs::PathFromString(options.data_dir);
+}
+
+auto BlocksDir(BtcK_ChainOptions const& options) -> fs::path
+{
+  if (options.blocks_dir == nullptr) {
+    return DataDir(options) / "blocks";
+  }
+  return fs::PathFromString(options.blocks_dir);
+}
+
+auto GetCacheSizes(BtcK_ChainOptions const& options) -> kernel::CacheSizes
+{
+  return kernel::CacheSizes{
+    options.cache_bytes != 0 ? options.cache_bytes : DEFAULT_KERNEL_CACHE};
+}
+
+static_assert(BtcK_BlockStatus_VALID_TREE == BLOCK_VALID_TREE);
+static_assert(BtcK_BlockStatus_VALID_TRANSACTIONS == BLOCK_VALID_TRANSACTIONS);
+static_assert(BtcK_BlockStatus_VALID_CHAIN == BLOCK_VALID_CHAIN);
+static_assert(BtcK_BlockStatus_VALID_SCRIPTS == BLOCK_VALID_SCRIPTS);
+static_assert(BtcK_BlockStatus_VALID_MASK == BLOCK_VALID_MASK);
+static_assert(BtcK_BlockStatus_HAVE_DATA == BLOCK_HAVE_DATA);
+static_assert(BtcK_BlockStatus_HAVE_UNDO == BLOCK_HAVE_UNDO);
+static_assert(BtcK_BlockStatus_FAILED_VALID == BLOCK_FAILED_VALID);
+static_assert(BtcK_BlockStatus_FAILED_CHILD == BLOCK_FAILED_CHILD);
+
+auto ToBlockHash(uint256 const& hash) -> BtcK_BlockHash
+{
+  auto out = BtcK_BlockHash{};
+  std::ranges::copy(hash, out.data);
+  return out;
+}
+
+auto DataPos(util::ChainEntry const& entry) -> FlatFilePos
+{
+  if ((entry.status & BLOCK_HAVE_DATA) == 0) {
+    throw std::runtime_error("Block data not available.");
+  }
+  return entry.pos;
+}
+
+auto MakeBlockHeader(CBlockIndex const& index) -> BtcK_BlockHeader
+{
+  auto const header = index.GetBlockHeader();
+  auto out = BtcK_BlockHeader{
+    .version = header.nVersion,
+    .prev_hash = ToBlockHash(header.hashPrevBlock),
+    .merkle_root = {},
+    .time = header.nTime,
+    .bits = header.nBits,
+    .nonce = header.nNonce,
+  };
+  std::ranges::copy(header.hashMerkleRoot, out.merkle_root);
+  return out;
+}
+
+// The header fields and the predecessors of a block index never change, the
+// rest is taken from the snapshot.
+auto MakeIndexEntry(util::ChainEntry const& entry) -> BtcK_BlockIndexEntry
+{
+  auto const& index = *entry.index;
+  auto out = BtcK_BlockIndexEntry{
+    .height = index.nHeight,
+    .hash = ToBlockHash(index.GetBlockHash()),
+    .prev_hash = {},
+    .time = index.nTime,
+    .median_time_past = index.GetMedianTimePast(),
+    .chain_work = {},
+    .num_transactions = entry.num_tx,
+    .status = entry.status,
+  };
+  if (index.pprev != nullptr) {
+    out.prev_hash = ToBlockHash(index.pprev->GetBlockHash());
+  }
+  std::ranges::copy(ArithToUint256(entry.chain_work), out.chain_work);
+  return out;
+}
+
+void ThrowOnFailure(
+  std::tuple<node::ChainstateLoadStatus, bilingual_str> const& result)
+{
+  auto const& [status, error] = result;
+  if (status != node::ChainstateLoadStatus::SUCCESS) {
+    throw std::runtime_error(error.original);
+  }
+}
+
+// Consecutive blocks of one file that a reader decodes in one go.
+struct ImportBatch {
+  std::size_t file;
+  std::size_t first;
+  std::size_t last;
+};
+
+constexpr auto import_batch_bytes = std::size_t{4} << 20;
+
+auto MakeImportBatches(
+  std::vector<std::vector<util::BlockRecord>> const& records)
+  -> std::vector<ImportBatch>
+{
+  auto batches = std::vector<ImportBatch>{};
+  for (std::size_t file = 0; file < records.size(); ++file) {
+    auto first = std::size_t{0};
+    auto bytes = std::size_t{0};
+    for (std::size_t idx = 0; idx < records[file].size(); ++idx) {
+      bytes += records[file][idx].size;
+      if (bytes >= import_batch_bytes || idx + 1 == records[file].size()) {
+        batches.push_back(ImportBatch{file, first, idx + 1});
+        first = idx + 1;
+        bytes = 0;
+      }
+    }
+  }
+  return batches;
+}
+
+// Where an import found a block: the index of the file in the import and
+// the position of the block in it.
+struct ImportPos {
+  std::size_t file;
+  util::BlockRecord record;
+};
+
+// Reads and decodes the block at `record`, or returns null if it does not
+// decode. The context-free checks, including the merkle root, are cached in
+// the block, so validation does not repeat them.
+auto ReadImportBlock(
+  util::FileDescriptor const& fd, util::BlockRecord const& record,
+  util::XorKey const& key, Consensus::Params const& consensus,
+  std::vector<std::uint8_t>& bytes) -> std::shared_ptr<CBlock const>
+{
+  bytes.resize(record.size);
+  fd.ReadAt(bytes, record.offset);
+  util::Deobfuscate(bytes, record.offset, key);
 
-//     auto SetWorkerThreads(int worker_threads) && -> KwArgs;
-//     auto SetWipeDbs(bool wipe_block_tree, bool wipe_chainstate) && -> KwArgs;
-//     auto SetBlockTreeDbInMemory(bool block_tree_db_in_memory) && -> KwArgs;
-//     auto SetChainstateDbInMemory(bool chainstate_db_in_memory) && -> KwArgs;
-//   };
+  auto block = std::make_shared<CBlock>();
+  try {
+    auto stream = DataStream{std::as_bytes(std::span{bytes})};
+    stream >> TX_WITH_WITNESS(*block);
+  }
+  catch (std::ios_base::failure const&) {
+    return nullptr;
+  }
+  auto state = BlockValidationState{};
+  CheckBlock(*block, state, consensus);
+  return block;
+}
+
+// Hands blocks to validation in the order they arrive. A block whose parent
+// is not known yet waits until the parent has been processed, since block
+// files are only roughly ordered by height. Like the block manager's import,
+// a waiting block is remembered by its position and read again once its
+// parent arrives, so that out of order files do not pile up decoded blocks.
+//
+// Given the numbers of the files in the chain's block files, blocks are
+// indexed where they are, as by the block manager's import, and connected by
+// Activate. Otherwise ProcessNewBlock writes every block into the chain's
+// block files and connects it right away.
+class BlockConnector
+{
+public:
+  BlockConnector(
+    ChainstateManager& chainman, std::span<fs::path const> files,
+    std::span<util::XorKey const> keys, std::span<int const> file_numbers)
+    : chainman_{chainman}, files_{files}, keys_{keys},
+      file_numbers_{file_numbers}
+  {}
+
+  // Takes the block found at `pos`, or null if it did not decode.
+  void Process(ImportPos const& pos, std::shared_ptr<CBlock const> block)
+  {
+    if (block == nullptr) {
+      ++skipped_;
+      return;
+    }
+    auto const& blockman = chainman_.m_blockman;
+    auto const& genesis = chainman_.GetConsensus().hashGenesisBlock;
+    auto const* parent = WITH_LOCK(
+      ::cs_main, return blockman.LookupBlockIndex(block->hashPrevBlock));
+    if (parent == nullptr && block->GetHash() != genesis) {
+      orphans_.emplace(block->hashPrevBlock, pos);
+      return;
+    }
+
+    auto pending =
+      std::vector<std::pair<ImportPos, std::shared_ptr<CBlock const>>>{};
+    pending.emplace_back(pos, std::move(block));
+    while (!pending.empty()) {
+      auto const [next_pos, next] = std::move(pending.back());
+      pending.pop_back();
+      // Invalid blocks are skipped, as by the block manager's import.
+      if (!Accept(next_pos, next)) {
+        ++skipped_;
+      }
+      auto const [first, last] = orphans_.equal_range(next->GetHash());
+      for (auto it = first; it != last; ++it) {
+        if (auto child = Read(it->second)) {
+          pending.emplace_back(it->second, std::move(child));
+        }
+        else {
+          ++skipped_;
+        }
+      }
+      orphans_.erase(first, last);
+    }
+  }
+
+  // Connects the blocks indexed in place so far.
+  void Activate()
+  {
+    if (file_numbers_.empty()) {
+      return;
+    }
+    auto state = BlockValidationState{};
+    if (!chainman_.ActiveChainstate().ActivateBestChain(state, nullptr)) {
+      throw std::runtime_error(state.ToString());
+    }
+  }
+
+  // Blocks that did not decode, failed validation or whose parent never
+  // arrived.
+  [[nodiscard]] auto Skipped() const -> std::size_t
+  {
+    return skipped_ + orphans_.size();
+  }
+
+private:
+  auto Accept(ImportPos const& pos, std::shared_ptr<CBlock const> const& block)
+    -> bool
+  {
+    if (file_numbers_.empty()) {
+      return chainman_.ProcessNewBlock(
+        block, /*force_processing=*/true, /*min_pow_checked=*/true,
+        /*new_block=*/nullptr);
+    }
+    auto const dbp = FlatFilePos{
+      file_numbers_[pos.file], static_cast<unsigned int>(pos.record.offset)};
+    auto state = BlockValidationState{};
+    LOCK(::cs_main);
+    return chainman_.AcceptBlock(
+      block, state, /*ppindex=*/nullptr, /*fRequested=*/true, &dbp,
+      /*fNewBlock=*/nullptr, /*min_pow_checked=*/true);
+  }
+
+  auto Read(ImportPos const& pos) -> std::shared_ptr<CBlock const>
+  {
+    auto const fd = util::FileDescriptor{files_[pos.file]};
+    return ReadImportBlock(
+      fd, pos.record, keys_[pos.file], chainman_.GetConsensus(), bytes_);
+  }
+
+  ChainstateManager& chainman_;
+  std::span<fs::path const> files_;
+  std::span<util::XorKey const> keys_;
+  std::span<int const> file_numbers_;
+  std::multimap<uint256, ImportPos> orphans_;
+  std::vector<std::uint8_t> bytes_;
+  std::size_t skipped_ = 0;
+};
+
+}  // namespace
+
+BtcK_Chain::BtcK_Chain(BtcK_ChainOptions const& options)
+  : chainparams{MakeChainParams(options.chain_type)}
+  , chainstate_manager{
+      interrupt,
+      ChainstateManager::Options{
+        .chainparams = *chainparams,
+        .datadir = DataDir(options),
+        .notifications = notifications,
+        .worker_threads_num = options.worker_threads,
+      },
+      node::BlockManager::Options{
+        .chainparams = *chainparams,
+        .use_xor = options.disable_block_file_obfuscation == 0,
+        .blocks_dir = BlocksDir(options),
+        .notifications = notifications,
+        .block_tree_db_params =
+          DBParams{
+            .path = DataDir(options) / "blocks" / "index",
+            .cache_bytes = GetCacheSizes(options).block_tree_db,
+            .memory_only = options.block_tree_db_in_memory != 0,
+            .wipe_data = options.wipe_block_tree_db != 0,
+          },
+      }}
+  , block_cache{options.block_cache_bytes}
+  , block_files{
+      BlocksDir(options), options.max_open_block_files,
+      util::ReadXorKey(BlocksDir(options)), chainparams->MessageStart()}
+{
+  if (auto const result = kernel::SanityChecks(context); !result) {
+    throw std::runtime_error(util::ErrorString(result).original);
+  }
+
+  auto load_options = node::ChainstateLoadOptions{};
+  load_options.coins_db_in_memory = options.chainstate_db_in_memory != 0;
+  load_options.wipe_chainstate_db = options.wipe_chainstate_db != 0;
+
+  ThrowOnFailure(node::LoadChainstate(
+    chainstate_manager, GetCacheSizes(options), load_options));
+  ThrowOnFailure(
+    node::VerifyLoadedChainstate(chainstate_manager, load_options));
+
+  auto const chainstates = WITH_LOCK(
+    chainstate_manager.GetMutex(), return chainstate_manager.GetAll());
+  for (auto* chainstate : chainstates) {
+    auto state = BlockValidationState{};
+    if (!chainstate->ActivateBestChain(state, nullptr)) {
+      throw std::runtime_error(state.ToString());
+    }
+  }
+  PublishSnapshot();
+}
+
+BtcK_Chain::~BtcK_Chain()
+{
+  LOCK(chainstate_manager.GetMutex());
+  for (auto* chainstate : chainstate_manager.GetAll()) {
+    if (chainstate->CanFlushToDisk()) {
+      chainstate->ForceFlushStateToDisk();
+      chainstate->ResetCoinsViews();
+    }
+  }
+}
 
-//   Chain(std::string_view data_dir, std::string_view blocks_dir, KwArgs kwargs = {});
-// BTCK_API struct BtcK_Chain* BtcK_Chain_New();
+auto ChainNotifications::blockTip(
+  SynchronizationState /*state*/, CBlockIndex& /*index*/,
+  double /*verification_progress*/) -> kernel::InterruptResult
+{
+  chain_.PublishSnapshot();
+  return {};
+}
+
+auto BtcK_Chain::LoadBlock(util::ChainEntry const& entry) const -> CBlockRef
+{
+  // The block manager's ReadBlock takes cs_main to look up the position, the
+  // position from the snapshot does not need it.
+  auto bytes = std::vector<std::uint8_t>{};
+  ReadRawBlock(DataPos(entry), bytes);
+  auto block = CBlock{};
+  auto stream = DataStream{std::as_bytes(std::span{bytes})};
+  stream >> TX_WITH_WITNESS(block);
+  if (block.GetHash() != entry.index->GetBlockHash()) {
+    throw std::runtime_error("Block hash mismatch.");
+  }
+  return util::MakeShared<CBlock>(std::move(block));
+}
+
+void BtcK_Chain::ReadRawBlock(
+  FlatFilePos const& pos, std::vector<std::uint8_t>& out) const
+{
+  if (block_files.Pooled()) {
+    block_files.ReadBlock(pos, out);
+  }
+  else if (!chainstate_manager.m_blockman.ReadRawBlock(out, pos)) {
+    throw std::runtime_error("Failed to read block.");
+  }
+}
+
+auto BtcK_Chain::ReadBlock(util::ChainEntry const& entry) const -> CBlockRef
+{
+  auto const hash = entry.index->GetBlockHash();
+  if (auto cached = block_cache.Get(hash)) {
+    return cached;
+  }
+
+  auto block = LoadBlock(entry);
+  block_cache.Put(hash, block);
+  return block;
+}
+
+auto BtcK_Chain::BlockPos(std::size_t height) const -> FlatFilePos
+{
+  return DataPos(Snapshot()->At(height));
+}
+
+auto BtcK_Chain::Snapshot() const
+  -> std::shared_ptr<util::ChainSnapshot const>
+{
+  auto const lock = std::lock_guard{snapshot_mutex};
+  return snapshot;
+}
+
+void BtcK_Chain::PublishSnapshot()
+{
+  // cs_main is recursive and usually held already, by validation.
+  LOCK(chainstate_manager.GetMutex());
+  auto next = std::make_shared<util::ChainSnapshot const>(
+    chainstate_manager.ActiveChain(), Snapshot().get());
+  // The previous snapshot is released after the lock, by `next`.
+  auto const lock = std::lock_guard{snapshot_mutex};
+  snapshot.swap(next);
+}
+
+auto BtcK_Chain::ResolveRange(std::size_t first, std::size_t last) const
+  -> std::vector<util::ChainEntry>
+{
+  auto const chain = Snapshot();
+  if (first > last || last > chain->Size()) {
+    throw std::out_of_range("Block range out of range.");
+  }
+  auto entries = std::vector<util::ChainEntry>{};
+  entries.reserve(last - first);
+  for (auto height = first; height < last; ++height) {
+    entries.push_back(chain->At(height));
+  }
+  return entries;
+}
 
 extern "C" {
 
+auto BtcK_Chain_New(BtcK_ChainOptions const* options, struct BtcK_Error** err)
+  -> BtcK_Chain*
+{
+  return util::WrapFn(err, [options] {
+    fs::create_directories(DataDir(*options));
+    fs::create_directories(BlocksDir(*options));
+    return new BtcK_Chain{*options};
+  });
+}
+
 void BtcK_Chain_Free(BtcK_Chain* self)
 {
   delete self;
@@ -47,7 +504,8 @@ void BtcK_Chain_Free(BtcK_Chain* self)
 
 auto BtcK_Chain_CountBlocks(BtcK_Chain const* self) -> std::size_t
 {
-  return self->chainstate_manager.ActiveChain().Height();
+  // The height of the tip, as CChain::Height() returned before snapshots.
+  return self->Snapshot()->Size() - 1;
 }
 
 auto BtcK_Chain_GetBlock(
@@ -55,26 +513,239 @@ auto BtcK_Chain_GetBlock(
   -> BtcK_Block*
 {
   return util::WrapFn(err, [self, idx] {
-    CBlockIndex* bi = self->chainstate_manager.ActiveChain()[int(idx)];
-    node::BlockManager const& bm = self->chainstate_manager.m_blockman;
+    return api::create<CBlockRef>(self->ReadBlock(self->Snapshot()->At(idx)));
+  });
+}
+
+auto BtcK_Chain_FindBlock(
+  BtcK_Chain const* self, BtcK_BlockHash const* block_hash) -> std::ptrdiff_t
+{
+  return self->Snapshot()->Find(uint256{std::span{block_hash->data}});
+}
 
-    auto block = CBlock{};
-    if (!bm.ReadBlock(block, *bi)) {
-      throw std::runtime_error("Failed to read block.");
+auto BtcK_Chain_GetRawBlock(
+  BtcK_Chain const* self, std::size_t height, BtcK_WriteBytes write,
+  void* userdata, struct BtcK_Error** err) -> int
+{
+  auto const ok = util::WrapFn(err, [=] {
+    auto bytes = std::vector<std::uint8_t>{};
+    self->ReadRawBlock(self->BlockPos(height), bytes);
+    if (write(bytes.data(), bytes.size(), userdata) != 0) {
+      throw std::system_error(std::make_error_code(std::errc::io_error));
     }
+    return true;
+  });
+  return ok ? 0 : -1;
+}
+
+auto BtcK_Chain_GetBlockUndo(
+  BtcK_Chain const* self, std::size_t height, struct BtcK_Error** err)
+  -> BtcK_BlockUndo*
+{
+  return util::WrapFn(err, [=] {
+    auto const& chainman = self->chainstate_manager;
+    // Reading the undo data takes cs_main briefly, to look up its position.
+    auto const* index = self->Snapshot()->At(height).index;
 
-    return api::create<CBlock>(std::move(block));
+    // The genesis block spends nothing and has no undo data.
+    auto undo = CBlockUndo{};
+    if (index->pprev != nullptr &&
+        !chainman.m_blockman.ReadBlockUndo(undo, *index)) {
+      throw std::runtime_error("Failed to read block undo data.");
+    }
+    return new BtcK_BlockUndo{std::move(undo)};
   });
 }
 
-auto BtcK_Chain_FindBlock(
-  BtcK_Chain const* self, BtcK_BlockHash const* block_hash) -> std::ptrdiff_t
+auto BtcK_Chain_GetBlockHeader(
+  BtcK_Chain const* self, std::size_t height, BtcK_BlockHeader* out,
+  struct BtcK_Error** err) -> int
 {
-  auto const hash = uint256{std::span{block_hash->data}};
-  auto const* bi = self->chainstate_manager.m_blockman.LookupBlockIndex(hash);
-  return (bi != nullptr && self->chainstate_manager.ActiveChain().Contains(bi))
-    ? bi->nHeight
-    : -1;
+  auto const ok = util::WrapFn(err, [=] {
+    // Header fields never change once the block index entry exists.
+    *out = MakeBlockHeader(*self->Snapshot()->At(height).index);
+    return true;
+  });
+  return ok ? 0 : -1;
+}
+
+auto BtcK_Chain_GetBlockIndexEntry(
+  BtcK_Chain const* self, std::size_t height, BtcK_BlockIndexEntry* out,
+  struct BtcK_Error** err) -> int
+{
+  return BtcK_Chain_GetBlockIndexEntries(self, height, height + 1, out, err);
+}
+
+auto BtcK_Chain_GetBlockIndexEntries(
+  BtcK_Chain const* self, std::size_t first, std::size_t last,
+  BtcK_BlockIndexEntry* out, struct BtcK_Error** err) -> int
+{
+  auto const ok = util::WrapFn(err, [=] {
+    auto const chain = self->Snapshot();
+    if (first > last || last > chain->Size()) {
+      throw std::out_of_range("Block range out of range.");
+    }
+    for (auto height = first; height < last; ++height) {
+      *out++ = MakeIndexEntry(chain->At(height));
+    }
+    return true;
+  });
+  return ok ? 0 : -1;
+}
+
+void BtcK_Chain_GetBlockCacheStats(
+  BtcK_Chain const* self, BtcK_BlockCacheStats* out)
+{
+  *out = self->block_cache.Stats();
+}
+
+auto BtcK_Chain_ExportBlocks(
+  BtcK_Chain const* self, std::size_t first, std::size_t last,
+  BtcK_ExportFormat format, BtcK_JsonOptions options, std::size_t num_threads,
+  BtcK_ExportSink sink, void* userdata, struct BtcK_Error** err) -> int
+{
+  auto const ok = util::WrapFn(err, [=] {
+    util::CheckExportFormat(format, options);
+    auto const index = self->ResolveRange(first, last);
+
+    util::ExportOrdered(
+      index.size(), num_threads,
+      [&](std::size_t idx, std::vector<std::byte>& out) {
+        auto const block = self->LoadBlock(index[idx]);
+        util::ExportBlock(*block, format, options, out);
+      },
+      util::SinkConsumer(sink, userdata, first));
+    return true;
+  });
+  return ok ? 0 : -1;
+}
+
+auto BtcK_Chain_ParallelScan(
+  BtcK_Chain const* self, std::size_t first, std::size_t last,
+  std::size_t shard_size, std::size_t num_threads, BtcK_ScanMap map,
+  BtcK_ScanReduce reduce, void* userdata, struct BtcK_Error** err) -> int
+{
+  auto const ok = util::WrapFn(err, [=] {
+    if (shard_size == 0) {
+      throw std::invalid_argument("Shard size must not be zero.");
+    }
+    auto const index = self->ResolveRange(first, last);
+    auto const cancel = [] {
+      throw std::system_error(
+        std::make_error_code(std::errc::operation_canceled));
+    };
+
+    // Each shard is a run of consecutive heights that one worker maps in
+    // order. Shards are reduced in order on the calling thread.
+    auto const num_shards =
+      index.size() / shard_size + (index.size() % shard_size != 0 ? 1 : 0);
+    util::ExportOrdered(
+      num_shards, num_threads,
+      [&](std::size_t shard, std::vector<std::byte>& /*out*/) {
+        auto const begin = shard * shard_size;
+        auto const end = begin + std::min(shard_size, index.size() - begin);
+        for (auto idx = begin; idx < end; ++idx) {
+          auto const ref = self->LoadBlock(index[idx]);
+          if (map(shard, first + idx, api::ref(ref), userdata) != 0) {
+            cancel();
+          }
+        }
+      },
+      [&](std::size_t shard, std::span<std::byte const> /*out*/) {
+        if (reduce != nullptr && reduce(shard, userdata) != 0) {
+          cancel();
+        }
+      });
+    return true;
+  });
+  return ok ? 0 : -1;
+}
+
+auto BtcK_Chain_ImportBlocks(
+  BtcK_Chain* self, char const* const* paths, std::size_t num_paths,
+  std::size_t num_threads, BtcK_ImportProgress progress, void* userdata,
+  std::size_t* blocks_skipped, struct BtcK_Error** err) -> int
+{
+  auto const ok = util::WrapFn(err, [=] {
+    auto const& magic = self->chainparams->MessageStart();
+    auto const& consensus = self->chainparams->GetConsensus();
+    auto files = std::vector<fs::path>{};
+    auto keys = std::vector<util::XorKey>{};
+    for (std::size_t idx = 0; idx < num_paths; ++idx) {
+      files.push_back(fs::PathFromString(paths[idx]));
+      keys.push_back(util::ReadXorKey(files.back().parent_path()));
+    }
+
+    // Files of the chain's own block files that the block manager has not
+    // written to yet are indexed in place. If any file is elsewhere, all
+    // blocks are copied, since the block manager appends copies to its last
+    // file, which may be one that is still being indexed. As after a reindex,
+    // blocks written later go after the last block indexed in the highest
+    // file.
+    auto const written = self->chainstate_manager.m_blockman.MaxBlockfileNum();
+    auto file_numbers = std::vector<int>{};
+    for (auto const& file : files) {
+      auto const number = self->block_files.FileNumber(file);
+      if (number <= written) {
+        file_numbers.clear();
+        break;
+      }
+      file_numbers.push_back(number);
+    }
+
+    // Locate the blocks in all files first, so that the readers can work on
+    // batches smaller than a file and progress has a total.
+    auto records = std::vector<std::vector<util::BlockRecord>>(files.size());
+    util::ParallelFor(files.size(), num_threads, [&](std::size_t idx) {
+      auto const fd = util::FileDescriptor{files[idx]};
+      records[idx] = util::ScanBlockFile(fd, keys[idx], magic);
+    });
+
+    auto const batches = MakeImportBatches(records);
+    auto total = std::size_t{0};
+    for (auto const& file : records) {
+      total += file.size();
+    }
+
+    // Readers decode the batches ahead of the calling thread, which connects
+    // them in file order.
+    auto decoded =
+      std::vector<std::vector<std::shared_ptr<CBlock const>>>(batches.size());
+    auto connector =
+      BlockConnector{self->chainstate_manager, files, keys, file_numbers};
+    auto done = std::size_t{0};
+    util::ExportOrdered(
+      batches.size(), num_threads,
+      [&](std::size_t idx, std::vector<std::byte>& /*out*/) {
+        auto const& batch = batches[idx];
+        auto const fd = util::FileDescriptor{files[batch.file]};
+        auto bytes = std::vector<std::uint8_t>{};
+        for (auto pos = batch.first; pos < batch.last; ++pos) {
+          decoded[idx].push_back(ReadImportBlock(
+            fd, records[batch.file][pos], keys[batch.file], consensus, bytes));
+        }
+      },
+      [&](std::size_t idx, std::span<std::byte const> /*out*/) {
+        auto const& batch = batches[idx];
+        auto blocks = std::exchange(decoded[idx], {});
+        for (auto pos = batch.first; pos < batch.last; ++pos) {
+          connector.Process(
+            ImportPos{batch.file, records[batch.file][pos]},
+            std::move(blocks[pos - batch.first]));
+        }
+        connector.Activate();
+        done += batches[idx].last - batches[idx].first;
+        if (progress != nullptr && progress(done, total, userdata) != 0) {
+          throw std::system_error(
+            std::make_error_code(std::errc::operation_canceled));
+        }
+      });
+    if (blocks_skipped != nullptr) {
+      *blocks_skipped = connector.Skipped();
+    }
+    return true;
+  });
+  return ok ? 0 : -1;
 }
 
 }  // extern "C"
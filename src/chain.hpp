@@ -4,8 +4,87 @@
 
 #pragma once
 
+#include <btck/btck.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flatfile.h"
+#include "kernel/chainparams.h"
+#include "kernel/context.h"
+#include "kernel/notifications_interface.h"
+#include "util/block_cache.hpp"
+#include "util/block_files.hpp"
+#include "util/chain_snapshot.hpp"
+#include "util/signalinterrupt.h"
 #include "validation.h"
 
+// Publishes a snapshot of the active chain after every tip change.
+// Validation calls it with cs_main held, so snapshots are published in the
+// order the tips were set.
+class ChainNotifications : public kernel::Notifications
+{
+public:
+  explicit ChainNotifications(BtcK_Chain& chain) : chain_{chain} {}
+
+  auto blockTip(
+    SynchronizationState state, CBlockIndex& index,
+    double verification_progress) -> kernel::InterruptResult override;
+
+private:
+  BtcK_Chain& chain_;
+};
+
 struct BtcK_Chain {
+  explicit BtcK_Chain(BtcK_ChainOptions const& options);
+  BtcK_Chain(BtcK_Chain const&) = delete;
+  auto operator=(BtcK_Chain const&) -> BtcK_Chain& = delete;
+  ~BtcK_Chain();
+
+  // Reads the block from disk, through the pooled block files if enabled.
+  // Safe to call from any number of threads at once. Throws if the block
+  // data is not available.
+  [[nodiscard]] auto LoadBlock(util::ChainEntry const& entry) const
+    -> CBlockRef;
+
+  // Reads the serialized, deobfuscated block at `pos`.
+  void ReadRawBlock(FlatFilePos const& pos, std::vector<std::uint8_t>& out)
+    const;
+
+  // Reads the block from disk, or takes it from the block cache.
+  [[nodiscard]] auto ReadBlock(util::ChainEntry const& entry) const
+    -> CBlockRef;
+
+  // Position of the block at `height` of the current snapshot in the block
+  // files. Throws if the block data is not available.
+  [[nodiscard]] auto BlockPos(std::size_t height) const -> FlatFilePos;
+
+  // The active chain as of the last tip change. Takes the snapshot mutex for
+  // as long as it takes to copy the pointer, and never cs_main.
+  [[nodiscard]] auto Snapshot() const
+    -> std::shared_ptr<util::ChainSnapshot const>;
+
+  // Publishes a snapshot of the active chain. Called by the notifications
+  // after every tip change, and once the chain is loaded.
+  void PublishSnapshot();
+
+  // The entries at the heights [first, last) of the current snapshot, so
+  // that workers can read the blocks without any lock.
+  [[nodiscard]] auto ResolveRange(std::size_t first, std::size_t last) const
+    -> std::vector<util::ChainEntry>;
+
+  std::unique_ptr<CChainParams const> chainparams;
+  kernel::Context context;
+  ChainNotifications notifications{*this};
+  util::SignalInterrupt interrupt;
   ChainstateManager chainstate_manager;
+  mutable util::BlockCache block_cache;
+  mutable util::BlockFiles block_files;
+  // Replaced as a whole, never modified. The mutex only guards the pointer,
+  // readers copy it and release the lock again.
+  mutable std::mutex snapshot_mutex;
+  std::shared_ptr<util::ChainSnapshot const> snapshot;
 };
@@ -0,0 +1,103 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "alloc.h"
+
+#include <btck/btck.h>  // IWYU pragma: associated
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+struct Allocator {
+  BtcK_AllocateFn allocate;
+  BtcK_DeallocateFn deallocate;
+  void* userdata;
+};
+
+constexpr auto default_allocator = Allocator{
+  .allocate = [](std::size_t size, void*) { return std::malloc(size); },
+  .deallocate = [](void* ptr, void*) { std::free(ptr); },
+  .userdata = nullptr,
+};
+
+// Null until the first allocation or BtcK_SetAllocator picks an allocator.
+// It is published with release and read with acquire, so a thread that sees
+// the custom allocator also sees its fields.
+auto g_allocator = std::atomic<Allocator const*>{nullptr};
+
+// Guards g_custom, so that only one BtcK_SetAllocator call writes it.
+auto g_custom_claimed = std::atomic<bool>{false};
+auto g_custom = Allocator{};
+
+auto GetAllocator() -> Allocator const&
+{
+  auto const* allocator = g_allocator.load(std::memory_order_acquire);
+  // The first allocation locks in the default allocator, unless a concurrent
+  // BtcK_SetAllocator call got there first.
+  if (allocator == nullptr && g_allocator.compare_exchange_strong(
+                                allocator, &default_allocator,
+                                std::memory_order_acquire)) {
+    allocator = &default_allocator;
+  }
+  return *allocator;
+}
+
+}  // namespace
+
+extern "C" {
+
+auto BtcK_SetAllocator(
+  BtcK_AllocateFn allocate, BtcK_DeallocateFn deallocate, void* userdata)
+  -> int
+{
+  if (allocate == nullptr || deallocate == nullptr) {
+    return -1;
+  }
+  if (g_custom_claimed.exchange(true, std::memory_order_relaxed)) {
+    return -1;
+  }
+  g_custom = Allocator{
+    .allocate = allocate,
+    .deallocate = deallocate,
+    .userdata = userdata,
+  };
+  // Fails once anything was allocated with the default allocator.
+  auto const* expected = static_cast<Allocator const*>(nullptr);
+  return g_allocator.compare_exchange_strong(
+           expected, &g_custom, std::memory_order_release,
+           std::memory_order_relaxed)
+           ? 0
+           : -1;
+}
+
+auto util_malloc(std::size_t size) -> void*
+{
+  auto const& allocator = GetAllocator();
+  return allocator.allocate(size, allocator.userdata);
+}
+
+void util_free(void* ptr)
+{
+  if (ptr == nullptr) {
+    return;
+  }
+  auto const& allocator = GetAllocator();
+  allocator.deallocate(ptr, allocator.userdata);
+}
+
+auto util_strdup(char const* str) -> char*
+{
+  auto const size = std::strlen(str) + 1;
+  auto* copy = static_cast<char*>(util_malloc(size));
+  if (copy != nullptr) {
+    std::memcpy(copy, str, size);
+  }
+  return copy;
+}
+
+}  // extern "C"
@@ -0,0 +1,21 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Allocation functions that go through the allocator installed with
+// BtcK_SetAllocator. The first call locks in the current allocator.
+void* util_malloc(size_t size);
+void util_free(void* ptr);
+char* util_strdup(char const* str);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
@@ -4,7 +4,17 @@
 
 #pragma once
 
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include "arena.hpp"
 #include "error.hpp"
+#include "memory_stats.hpp"
+#include "pool.hpp"
 #include "type_mapping.hpp"
 
 namespace api {
@@ -34,7 +44,59 @@ template <c_type T>
 template <cpp_type T, typename... Args>
 [[nodiscard]] auto create(Args&&... args) -> c_type_t<T>*
 {
-  return reinterpret_cast<c_type_t<T>*>(new T(std::forward<Args>(args)...));
+  auto* storage = util::Pool<T>::Allocate();
+  try {
+    auto* self = ::new (storage) T(std::forward<Args>(args)...);
+    util::MemoryStats::Track(*self);
+    return reinterpret_cast<c_type_t<T>*>(self);
+  }
+  catch (...) {
+    util::Pool<T>::Deallocate(storage);
+    throw;
+  }
+}
+
+// Creates the object in caller-owned `storage`, which must be suitably sized
+// and aligned for T. The caller releases it with destroy().
+template <cpp_type T, typename... Args>
+[[nodiscard]] auto create_at(void* storage, Args&&... args) -> c_type_t<T>*
+{
+  if (reinterpret_cast<std::uintptr_t>(storage) % alignof(T) != 0) {
+    throw std::invalid_argument("Misaligned storage.");
+  }
+  auto* self = ::new (storage) T(std::forward<Args>(args)...);
+  util::MemoryStats::Track(*self);
+  return reinterpret_cast<c_type_t<T>*>(self);
+}
+
+// Creates the object in `arena`, or on its own if `arena` is null.
+template <cpp_type T, typename... Args>
+[[nodiscard]] auto create_in(BtcK_Arena* arena, Args&&... args)
+  -> c_type_t<T>*
+{
+  if (arena == nullptr) {
+    return create<T>(std::forward<Args>(args)...);
+  }
+  auto* self = get(arena).Create<T>(std::forward<Args>(args)...);
+  return reinterpret_cast<c_type_t<T>*>(self);
+}
+
+template <c_type T>
+[[nodiscard]] auto copy_in(BtcK_Arena* arena, T const* self, BtcK_Error** err)
+  -> T*
+{
+  return util::WrapFn(err, [arena, self] {
+    return api::create_in<cpp_type_t<T>>(arena, get(self));
+  });
+}
+
+template <c_type T>
+[[nodiscard]] auto copy_at(void* storage, T const* self, BtcK_Error** err)
+  -> T*
+{
+  return util::WrapFn(err, [storage, self] {
+    return api::create_at<cpp_type_t<T>>(storage, get(self));
+  });
 }
 
 template <c_type T>
@@ -44,9 +106,36 @@ template <c_type T>
     err, [self] { return api::create<cpp_type_t<T>>(get(self)); });
 }
 
+// Destroys an object given as its C++ type, for handles that map to more
+// than one.
+template <cpp_type T> void destroy_object(T* obj)
+{
+  // Objects created in an arena are destroyed by the arena.
+  assert(!util::Arena::Contains(obj));
+  util::MemoryStats::Untrack(*obj);
+  std::destroy_at(obj);
+}
+
+template <cpp_type T> void free_object(T* obj)
+{
+  destroy_object(obj);
+  util::Pool<T>::Deallocate(obj);
+}
+
+template <c_type T> void destroy(T* self)
+{
+  if (self == nullptr) {
+    return;
+  }
+  destroy_object(reinterpret_cast<cpp_type_t<T>*>(self));
+}
+
 template <c_type T> void free(T* self)
 {
-  delete reinterpret_cast<cpp_type_t<T>*>(self);
+  if (self == nullptr) {
+    return;
+  }
+  free_object(reinterpret_cast<cpp_type_t<T>*>(self));
 }
 
 }  // namespace api
@@ -0,0 +1,154 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "alloc.h"
+#include "memory_stats.hpp"
+
+namespace util {
+
+// Bump allocator for handles whose lifetime ends all at once. Objects are
+// destroyed in reverse order of creation by Reset() or the destructor. Reset()
+// keeps the chunks, so an arena reused per batch stops allocating once it has
+// grown to the size of a batch.
+class Arena
+{
+public:
+  Arena() = default;
+  Arena(Arena const&) = delete;
+  auto operator=(Arena const&) -> Arena& = delete;
+  ~Arena()
+  {
+    Reset();
+#ifndef NDEBUG
+    auto& ranges = GetRanges();
+    auto const lock = std::lock_guard{ranges.mutex};
+    for (auto const& chunk : chunks_) {
+      ranges.ends.erase(reinterpret_cast<std::uintptr_t>(chunk.data.get()));
+    }
+#endif
+  }
+
+  template <typename T, typename... Args> auto Create(Args&&... args) -> T*
+  {
+    static_assert(alignof(T) <= alignof(Header));
+    auto* header = ::new (Allocate(sizeof(Header) + sizeof(T))) Header{};
+    auto* obj = ::new (static_cast<void*>(header + 1))
+      T(std::forward<Args>(args)...);
+    header->destroy = [](void* ptr) {
+      auto* obj = static_cast<T*>(ptr);
+      MemoryStats::Untrack(*obj);
+      obj->~T();
+    };
+    header->prev = std::exchange(last_, header);
+    MemoryStats::Track(*obj);
+    return obj;
+  }
+
+  void Reset() noexcept
+  {
+    for (auto* header = last_; header != nullptr; header = header->prev) {
+      header->destroy(header + 1);
+    }
+    last_ = nullptr;
+    chunk_ = 0;
+    used_ = 0;
+  }
+
+  // Whether `ptr` points into a live arena. Objects there belong to the arena
+  // and must not be freed on their own. Only tracked in debug builds, where
+  // api::free asserts on it, and always false otherwise.
+  [[nodiscard]] static auto Contains([[maybe_unused]] void const* ptr) -> bool
+  {
+#ifndef NDEBUG
+    auto& ranges = GetRanges();
+    auto const lock = std::lock_guard{ranges.mutex};
+    auto const addr = reinterpret_cast<std::uintptr_t>(ptr);
+    auto const it = ranges.ends.upper_bound(addr);
+    return it != ranges.ends.begin() && addr < std::prev(it)->second;
+#else
+    return false;
+#endif
+  }
+
+private:
+  static constexpr std::size_t chunk_size = 64 * 1024;
+
+  struct alignas(std::max_align_t) Header {
+    void (*destroy)(void*);
+    Header* prev;
+  };
+
+  struct Free {
+    void operator()(std::byte* ptr) const { util_free(ptr); }
+  };
+
+  struct Chunk {
+    std::unique_ptr<std::byte[], Free> data;
+    std::size_t size;
+  };
+
+#ifndef NDEBUG
+  // The address ranges of all chunks, from begin to end.
+  struct Ranges {
+    std::mutex mutex;
+    std::map<std::uintptr_t, std::uintptr_t> ends;
+  };
+
+  // Leaked, so that arenas held by static objects can still be destroyed.
+  static auto GetRanges() -> Ranges&
+  {
+    static auto& ranges = *new Ranges{};
+    return ranges;
+  }
+#endif
+
+  auto Allocate(std::size_t size) -> void*
+  {
+    size = (size + alignof(Header) - 1) / alignof(Header) * alignof(Header);
+    for (; chunk_ < chunks_.size(); ++chunk_, used_ = 0) {
+      auto& chunk = chunks_[chunk_];
+      if (chunk.size - used_ >= size) {
+        return chunk.data.get() + std::exchange(used_, used_ + size);
+      }
+    }
+    auto const n = std::max(chunk_size, size);
+    auto data = std::unique_ptr<std::byte[], Free>{
+      static_cast<std::byte*>(util_malloc(n))};
+    if (data == nullptr) {
+      throw std::bad_alloc();
+    }
+    chunks_.push_back(Chunk{std::move(data), n});
+#ifndef NDEBUG
+    {
+      auto& ranges = GetRanges();
+      auto const lock = std::lock_guard{ranges.mutex};
+      auto const begin =
+        reinterpret_cast<std::uintptr_t>(chunks_.back().data.get());
+      ranges.ends.emplace(begin, begin + n);
+    }
+#endif
+    used_ = size;
+    return chunks_.back().data.get();
+  }
+
+  std::vector<Chunk> chunks_;
+  std::size_t chunk_ = 0;
+  std::size_t used_ = 0;
+  Header* last_ = nullptr;
+};
+
+}  // namespace util
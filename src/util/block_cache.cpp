@@ -0,0 +1,70 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "block_cache.hpp"
+
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+#include "memory_stats.hpp"
+
+namespace util {
+
+auto BlockCache::Get(uint256 const& hash) -> CBlockRef
+{
+  if (max_bytes_ == 0) {
+    return nullptr;
+  }
+  auto const lock = std::lock_guard{mutex_};
+  auto const it = index_.find(hash);
+  if (it == index_.end()) {
+    ++misses_;
+    return nullptr;
+  }
+  ++hits_;
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->block;
+}
+
+void BlockCache::Put(uint256 const& hash, CBlockRef block)
+{
+  auto const bytes = sizeof(CBlock) + DynamicMemoryUsage(block);
+  if (bytes > max_bytes_) {
+    return;
+  }
+
+  auto const lock = std::lock_guard{mutex_};
+  if (auto const it = index_.find(hash); it != index_.end()) {
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return;
+  }
+  entries_.push_front(Entry{hash, std::move(block), bytes});
+  index_.emplace(hash, entries_.begin());
+  bytes_ += bytes;
+  Evict();
+}
+
+auto BlockCache::Stats() const -> BtcK_BlockCacheStats
+{
+  auto const lock = std::lock_guard{mutex_};
+  return BtcK_BlockCacheStats{
+    .hits = hits_,
+    .misses = misses_,
+    .entries = entries_.size(),
+    .bytes = bytes_,
+  };
+}
+
+void BlockCache::Evict()
+{
+  while (bytes_ > max_bytes_) {
+    auto const& entry = entries_.back();
+    bytes_ -= entry.bytes;
+    index_.erase(entry.hash);
+    entries_.pop_back();
+  }
+}
+
+}  // namespace util
@@ -0,0 +1,68 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <btck/btck.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "crypto/common.h"
+#include "type_mapping.hpp"
+#include "uint256.h"
+
+namespace util {
+
+// Least recently used set of decoded blocks, keyed by block hash and bounded
+// by the dynamic memory usage of the blocks it holds. Blocks are immutable and
+// shared, so a hit hands out another reference without copying. A capacity of
+// zero disables the cache.
+class BlockCache
+{
+public:
+  explicit BlockCache(std::size_t max_bytes) : max_bytes_{max_bytes} {}
+  BlockCache(BlockCache const&) = delete;
+  auto operator=(BlockCache const&) -> BlockCache& = delete;
+
+  // Returns the cached block, or null and counts a miss.
+  [[nodiscard]] auto Get(uint256 const& hash) -> CBlockRef;
+
+  void Put(uint256 const& hash, CBlockRef block);
+
+  [[nodiscard]] auto Stats() const -> BtcK_BlockCacheStats;
+
+private:
+  struct Entry {
+    uint256 hash;
+    CBlockRef block;
+    std::size_t bytes;
+  };
+
+  using List = std::list<Entry>;
+
+  // Block hashes are already uniformly distributed.
+  struct Hasher {
+    auto operator()(uint256 const& hash) const -> std::size_t
+    {
+      return ReadLE64(hash.begin());
+    }
+  };
+
+  void Evict();
+
+  std::size_t max_bytes_;
+  mutable std::mutex mutex_;
+  List entries_;
+  std::unordered_map<uint256, List::iterator, Hasher> index_;
+  std::size_t bytes_ = 0;
+  std::uint64_t hits_ = 0;
+  std::uint64_t misses_ = 0;
+};
+
+}  // namespace util
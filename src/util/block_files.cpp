@@ -0,0 +1,315 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "block_files.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+#include "consensus/consensus.h"
+#include "crypto/common.h"
+#include "tinyformat.h"
+
+namespace util {
+
+auto ReadXorKey(fs::path const& blocks_dir) -> XorKey
+{
+  auto key = XorKey{};
+  auto file = std::ifstream{blocks_dir / "xor.dat", std::ios::binary};
+  file.read(reinterpret_cast<char*>(key.data()), key.size());
+  return file ? key : XorKey{};
+}
+
+void Deobfuscate(
+  std::span<std::uint8_t> bytes, std::uint64_t offset, XorKey const& key)
+{
+  if (std::ranges::all_of(key, [](auto b) { return b == 0; })) {
+    return;
+  }
+  for (std::size_t i = 0; i < bytes.size(); ++i) {
+    bytes[i] ^= key[(offset + i) % key.size()];
+  }
+}
+
+#ifndef _WIN32
+
+FileDescriptor::FileDescriptor(fs::path const& path)
+  : fd_{open(path.c_str(), O_RDONLY | O_CLOEXEC)}
+{
+  if (fd_ < 0) {
+    throw std::system_error(errno, std::generic_category());
+  }
+}
+
+FileDescriptor::~FileDescriptor()
+{
+  close(fd_);
+}
+
+auto FileDescriptor::Size() const -> std::uint64_t
+{
+  struct stat status{};
+  if (fstat(fd_, &status) != 0) {
+    throw std::system_error(errno, std::generic_category());
+  }
+  return static_cast<std::uint64_t>(status.st_size);
+}
+
+void FileDescriptor::ReadAt(
+  std::span<std::uint8_t> buffer, std::uint64_t offset) const
+{
+  while (!buffer.empty()) {
+    auto const n =
+      pread(fd_, buffer.data(), buffer.size(), static_cast<off_t>(offset));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      throw std::system_error(errno, std::generic_category());
+    }
+    if (n == 0) {
+      throw std::runtime_error("Unexpected end of block file.");
+    }
+    buffer = buffer.subspan(static_cast<std::size_t>(n));
+    offset += static_cast<std::uint64_t>(n);
+  }
+}
+
+#else
+
+namespace {
+
+[[noreturn]] void ThrowLastError()
+{
+  throw std::system_error(
+    static_cast<int>(GetLastError()), std::system_category());
+}
+
+}  // namespace
+
+// Shares write and delete access, so that the block manager can keep
+// appending to the file while it is open here.
+FileDescriptor::FileDescriptor(fs::path const& path)
+  : fd_{CreateFileW(
+      path.c_str(), GENERIC_READ,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr)}
+{
+  if (fd_ == INVALID_HANDLE_VALUE) {
+    ThrowLastError();
+  }
+}
+
+FileDescriptor::~FileDescriptor()
+{
+  CloseHandle(fd_);
+}
+
+auto FileDescriptor::Size() const -> std::uint64_t
+{
+  auto size = LARGE_INTEGER{};
+  if (GetFileSizeEx(fd_, &size) == 0) {
+    ThrowLastError();
+  }
+  return static_cast<std::uint64_t>(size.QuadPart);
+}
+
+// ReadFile with an OVERLAPPED offset on a synchronous handle reads at that
+// offset, which is the Windows counterpart of pread.
+void FileDescriptor::ReadAt(
+  std::span<std::uint8_t> buffer, std::uint64_t offset) const
+{
+  while (!buffer.empty()) {
+    auto overlapped = OVERLAPPED{};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    auto const request =
+      static_cast<DWORD>(std::min<std::size_t>(buffer.size(), MAXDWORD));
+    auto n = DWORD{0};
+    if (
+      ReadFile(fd_, buffer.data(), request, &n, &overlapped) == 0 &&
+      GetLastError() != ERROR_HANDLE_EOF) {
+      ThrowLastError();
+    }
+    if (n == 0) {
+      throw std::runtime_error("Unexpected end of block file.");
+    }
+    buffer = buffer.subspan(n);
+    offset += n;
+  }
+}
+
+#endif
+
+namespace {
+
+// Offset of the next occurrence of `magic` at or after `offset`, or `size`
+// if there is none.
+auto FindMagic(
+  FileDescriptor const& fd, std::uint64_t offset, std::uint64_t size,
+  XorKey const& key, std::array<std::uint8_t, 4> const& magic)
+  -> std::uint64_t
+{
+  auto window = std::vector<std::uint8_t>(64 * 1024);
+  while (offset + magic.size() <= size) {
+    auto const bytes = std::span{window}.first(
+      std::min<std::uint64_t>(window.size(), size - offset));
+    fd.ReadAt(bytes, offset);
+    Deobfuscate(bytes, offset, key);
+    auto const found = std::ranges::search(bytes, magic);
+    if (!found.empty()) {
+      return offset + static_cast<std::uint64_t>(found.begin() - bytes.begin());
+    }
+    // Overlap windows, so that a magic split between two is still found.
+    offset += bytes.size() - (magic.size() - 1);
+  }
+  return size;
+}
+
+}  // namespace
+
+auto ScanBlockFile(
+  FileDescriptor const& fd, XorKey const& key,
+  std::array<std::uint8_t, 4> const& magic) -> std::vector<BlockRecord>
+{
+  auto records = std::vector<BlockRecord>{};
+  auto const size = fd.Size();
+  auto header = std::array<std::uint8_t, 8>{};
+  auto offset = std::uint64_t{0};
+  while (offset + header.size() <= size) {
+    fd.ReadAt(header, offset);
+    Deobfuscate(header, offset, key);
+    if (!std::equal(magic.begin(), magic.end(), header.begin())) {
+      offset = FindMagic(fd, offset + 1, size, key, magic);
+      continue;
+    }
+    auto const block_size = ReadLE32(header.data() + magic.size());
+    auto const begin = offset + header.size();
+    if (block_size < 80 || block_size > MAX_BLOCK_SERIALIZED_SIZE ||
+        block_size > size - begin) {
+      offset = FindMagic(fd, offset + 1, size, key, magic);
+      continue;
+    }
+    records.push_back(BlockRecord{begin, block_size});
+    offset = begin + block_size;
+  }
+  return records;
+}
+
+BlockFiles::BlockFiles(
+  fs::path blocks_dir, std::size_t max_open, XorKey const& xor_key,
+  std::array<std::uint8_t, 4> const& magic)
+  : blocks_dir_{std::move(blocks_dir)}
+  , max_open_{max_open}
+  , xor_key_{xor_key}
+  , magic_{magic}
+{}
+
+auto BlockFiles::Obfuscated() const -> bool
+{
+  return std::ranges::any_of(xor_key_, [](auto b) { return b != 0; });
+}
+
+auto BlockFiles::FileNumber(fs::path const& path) const -> int
+{
+  auto const name = fs::PathToString(path.filename());
+  if (
+    name.size() != 12 || !name.starts_with("blk") || !name.ends_with(".dat")) {
+    return -1;
+  }
+  auto number = 0;
+  for (auto const c : std::string_view{name}.substr(3, 5)) {
+    if (c < '0' || c > '9') {
+      return -1;
+    }
+    number = number * 10 + (c - '0');
+  }
+
+  auto const dir =
+    path.has_parent_path() ? path.parent_path() : fs::u8path(".");
+  auto ec = std::error_code{};
+  return std::filesystem::equivalent(dir, blocks_dir_, ec) ? number : -1;
+}
+
+auto BlockFiles::Open(int file) -> std::shared_ptr<FileDescriptor const>
+{
+  if (max_open_ != 0) {
+    auto const lock = std::lock_guard{mutex_};
+    if (auto const it = index_.find(file); it != index_.end()) {
+      files_.splice(files_.begin(), files_, it->second);
+      return it->second->second;
+    }
+  }
+
+  // Open outside the lock, so that a slow open does not stall readers of
+  // other files. Racing openers of the same file keep the first one.
+  auto fd = std::make_shared<FileDescriptor const>(
+    blocks_dir_ / fs::u8path(strprintf("blk%05u.dat", file)));
+  if (max_open_ == 0) {
+    return fd;
+  }
+
+  auto const lock = std::lock_guard{mutex_};
+  if (auto const it = index_.find(file); it != index_.end()) {
+    return it->second->second;
+  }
+  files_.emplace_front(file, fd);
+  index_.emplace(file, files_.begin());
+  while (files_.size() > max_open_) {
+    index_.erase(files_.back().first);
+    files_.pop_back();
+  }
+  return fd;
+}
+
+auto BlockFiles::BlockSize(FileDescriptor const& fd, FlatFilePos const& pos)
+  const -> std::size_t
+{
+  auto header = std::array<std::uint8_t, 8>{};
+  if (pos.nPos < header.size()) {
+    throw std::runtime_error("Invalid block position.");
+  }
+  auto const offset = std::uint64_t{pos.nPos} - header.size();
+  fd.ReadAt(header, offset);
+  Deobfuscate(header, offset, xor_key_);
+
+  if (!std::equal(magic_.begin(), magic_.end(), header.begin())) {
+    throw std::runtime_error("Block magic mismatch.");
+  }
+  auto const size = std::size_t{ReadLE32(header.data() + magic_.size())};
+  if (size > MAX_BLOCK_SERIALIZED_SIZE) {
+    throw std::runtime_error("Block size too large.");
+  }
+  return size;
+}
+
+void BlockFiles::ReadBlock(
+  FlatFilePos const& pos, std::vector<std::uint8_t>& out)
+{
+  auto const fd = Open(pos.nFile);
+  out.resize(BlockSize(*fd, pos));
+  fd->ReadAt(out, pos.nPos);
+  Deobfuscate(out, pos.nPos, xor_key_);
+}
+
+}  // namespace util
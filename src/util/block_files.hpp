@@ -0,0 +1,116 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "flatfile.h"
+#include "util/fs.h"
+
+namespace util {
+
+using XorKey = std::array<std::uint8_t, 8>;
+
+// Reads the key from xor.dat in `blocks_dir`. The block manager writes an all
+// zero key when obfuscation is disabled.
+auto ReadXorKey(fs::path const& blocks_dir) -> XorKey;
+
+// XORs `bytes`, which start at `offset` in their file, with the key.
+void Deobfuscate(
+  std::span<std::uint8_t> bytes, std::uint64_t offset, XorKey const& key);
+
+// Read-only block file. A file descriptor, or a file handle on Windows.
+class FileDescriptor
+{
+public:
+#ifndef _WIN32
+  using Handle = int;
+#else
+  using Handle = void*;
+#endif
+
+  explicit FileDescriptor(fs::path const& path);
+  FileDescriptor(FileDescriptor const&) = delete;
+  auto operator=(FileDescriptor const&) -> FileDescriptor& = delete;
+  ~FileDescriptor();
+
+  [[nodiscard]] auto get() const -> Handle { return fd_; }
+  [[nodiscard]] auto Size() const -> std::uint64_t;
+
+  // Reads exactly `buffer.size()` bytes at `offset`. Positional reads do not
+  // move a shared file offset, so any number of threads may read at once.
+  void ReadAt(std::span<std::uint8_t> buffer, std::uint64_t offset) const;
+
+private:
+  Handle fd_;
+};
+
+// Position and size of a serialized block in a block file.
+struct BlockRecord {
+  std::uint64_t offset;
+  std::uint32_t size;
+};
+
+// Finds the blocks in a block file, each preceded by the network magic and
+// its size. Like the block manager's import, anything between blocks that
+// does not start with the magic is skipped, such as the zeros that pad
+// preallocated files.
+auto ScanBlockFile(
+  FileDescriptor const& fd, XorKey const& key,
+  std::array<std::uint8_t, 4> const& magic) -> std::vector<BlockRecord>;
+
+// Open blk?????.dat files, shared by all readers of a chain and bounded by
+// `max_open`, least recently used first out. A file evicted while a reader
+// still uses it is closed when that reader is done. With `max_open` of zero
+// every read opens the file on its own.
+class BlockFiles
+{
+public:
+  BlockFiles(
+    fs::path blocks_dir, std::size_t max_open, XorKey const& xor_key,
+    std::array<std::uint8_t, 4> const& magic);
+  BlockFiles(BlockFiles const&) = delete;
+  auto operator=(BlockFiles const&) -> BlockFiles& = delete;
+
+  [[nodiscard]] auto Pooled() const -> bool { return max_open_ != 0; }
+  [[nodiscard]] auto Obfuscated() const -> bool;
+
+  [[nodiscard]] auto Open(int file) -> std::shared_ptr<FileDescriptor const>;
+
+  // Number of the block file at `path` if it is one of the blk?????.dat
+  // files in the blocks directory, or -1.
+  [[nodiscard]] auto FileNumber(fs::path const& path) const -> int;
+
+  // Size of the block at `pos`, after checking the network magic and size
+  // that precede it.
+  [[nodiscard]] auto BlockSize(FileDescriptor const& fd, FlatFilePos const& pos)
+    const -> std::size_t;
+
+  // Reads and deobfuscates the serialized block at `pos`.
+  void ReadBlock(FlatFilePos const& pos, std::vector<std::uint8_t>& out);
+
+private:
+  using List = std::list<std::pair<int, std::shared_ptr<FileDescriptor const>>>;
+
+  fs::path const blocks_dir_;
+  std::size_t const max_open_;
+  XorKey const xor_key_;
+  std::array<std::uint8_t, 4> const magic_;
+
+  std::mutex mutex_;
+  List files_;
+  std::unordered_map<int, List::iterator> index_;
+};
+
+}  // namespace util
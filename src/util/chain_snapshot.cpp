@@ -0,0 +1,120 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "chain_snapshot.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+#include "kernel/cs_main.h"
+#include "sync.h"
+
+namespace util {
+
+namespace {
+
+auto MakeEntry(CBlockIndex const& index) -> ChainEntry
+{
+  AssertLockHeld(::cs_main);
+  return ChainEntry{
+    .index = &index,
+    .chain_work = index.nChainWork,
+    .pos = index.GetBlockPos(),
+    .status = index.nStatus,
+    .num_tx = index.nTx,
+  };
+}
+
+}  // namespace
+
+void ChainSnapshot::HashIndex::Add(std::span<ChainEntry const> entries)
+{
+  auto const lock = std::unique_lock{mutex_};
+  for (auto const& entry : entries) {
+    blocks_.insert_or_assign(entry.index->GetBlockHash(), entry.index);
+  }
+}
+
+auto ChainSnapshot::HashIndex::Get(uint256 const& hash) const
+  -> CBlockIndex const*
+{
+  auto const lock = std::shared_lock{mutex_};
+  auto const it = blocks_.find(hash);
+  return (it != blocks_.end()) ? it->second : nullptr;
+}
+
+ChainSnapshot::ChainSnapshot(CChain const& chain, ChainSnapshot const* prev)
+  : hashes_{prev != nullptr ? prev->hashes_ : std::make_shared<HashIndex>()},
+    size_{static_cast<std::size_t>(chain.Height() + 1)}
+{
+  AssertLockHeld(::cs_main);
+  auto keep = std::size_t{0};
+  if (prev != nullptr && prev->size_ != 0) {
+    if (auto const* fork = chain.FindFork(prev->Get(prev->size_ - 1).index)) {
+      keep = std::min(static_cast<std::size_t>(fork->nHeight + 1), size_);
+    }
+  }
+
+  // Complete chunks below the fork are shared. The chunk the fork falls in
+  // is shared too if no snapshot has seen entries above the fork in it yet,
+  // otherwise its entries up to the fork are copied.
+  auto const shared = keep / chunk_size;
+  chunks_.reserve((size_ + chunk_size - 1) / chunk_size);
+  if (shared != 0) {
+    chunks_.assign(prev->chunks_.begin(), prev->chunks_.begin() + shared);
+  }
+  if (auto const offset = keep % chunk_size; offset != 0) {
+    auto const& last = prev->chunks_[shared];
+    if (last->filled == offset) {
+      chunks_.push_back(last);
+    }
+    else {
+      auto copy = std::make_shared<Chunk>();
+      std::copy_n(last->entries.begin(), offset, copy->entries.begin());
+      copy->filled = offset;
+      chunks_.push_back(std::move(copy));
+    }
+  }
+
+  for (auto height = keep; height < size_; ++height) {
+    if (height % chunk_size == 0) {
+      chunks_.push_back(std::make_shared<Chunk>());
+    }
+    auto& chunk = *chunks_.back();
+    chunk.entries[height % chunk_size] =
+      MakeEntry(*chain[static_cast<int>(height)]);
+    chunk.filled = height % chunk_size + 1;
+  }
+
+  // Blocks below the fork are indexed already.
+  for (auto first = keep; first < size_;) {
+    auto const last = std::min((first / chunk_size + 1) * chunk_size, size_);
+    hashes_->Add(std::span{chunks_[first / chunk_size]->entries}.subspan(
+      first % chunk_size, last - first));
+    first = last;
+  }
+}
+
+auto ChainSnapshot::At(std::size_t height) const -> ChainEntry const&
+{
+  if (height >= size_) {
+    throw std::out_of_range("Block height out of range.");
+  }
+  return Get(height);
+}
+
+auto ChainSnapshot::Find(uint256 const& hash) const -> std::ptrdiff_t
+{
+  auto const* index = hashes_->Get(hash);
+  if (index == nullptr) {
+    return -1;
+  }
+  auto const height = static_cast<std::size_t>(index->nHeight);
+  return (height < size_ && Get(height).index == index)
+    ? static_cast<std::ptrdiff_t>(height)
+    : -1;
+}
+
+}  // namespace util
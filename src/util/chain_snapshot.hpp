@@ -0,0 +1,108 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "arith_uint256.h"
+#include "chain.h"
+#include "crypto/common.h"
+#include "flatfile.h"
+#include "uint256.h"
+
+namespace util {
+
+// A block of the active chain as of a snapshot. The hash, height, header and
+// predecessor of a block index never change, the fields validation updates
+// under cs_main are copied, so that readers need neither.
+struct ChainEntry {
+  CBlockIndex const* index = nullptr;
+  arith_uint256 chain_work;
+  // Position of the block data, if `status` has BLOCK_HAVE_DATA.
+  FlatFilePos pos;
+  std::uint32_t status = 0;
+  unsigned int num_tx = 0;
+};
+
+// Immutable copy of the active chain that maps heights to chain entries and
+// block hashes to heights, readable without cs_main. The chain is stored in
+// fixed-size chunks and a snapshot shares every chunk below the fork point
+// with its predecessor. A snapshot that extends its predecessor writes the
+// new entries into the unused tail of the last chunk, which no snapshot can
+// see yet, so publishing after every block copies the chunk table only.
+// Entries are not refreshed once written, which is exact as long as blocks
+// of the active chain are not pruned.
+class ChainSnapshot
+{
+public:
+  // Snapshot of `chain`, sharing chunks with `prev` if given. Requires
+  // cs_main, and `prev` must be the last snapshot built from the chain.
+  ChainSnapshot(CChain const& chain, ChainSnapshot const* prev);
+  ChainSnapshot(ChainSnapshot const&) = delete;
+  auto operator=(ChainSnapshot const&) -> ChainSnapshot& = delete;
+
+  [[nodiscard]] auto Size() const -> std::size_t { return size_; }
+
+  // Throws std::out_of_range if `height` is not below Size().
+  [[nodiscard]] auto At(std::size_t height) const -> ChainEntry const&;
+
+  // Height of the block with the given hash, or -1 if it is not part of the
+  // snapshot. Takes the hash index lock shared, see HashIndex.
+  [[nodiscard]] auto Find(uint256 const& hash) const -> std::ptrdiff_t;
+
+private:
+  static constexpr std::size_t chunk_size = 4096;
+
+  // Entries at and above `filled` have not been part of any snapshot. Only
+  // the builder of the next snapshot touches them, under cs_main.
+  struct Chunk {
+    std::array<ChainEntry, chunk_size> entries;
+    std::size_t filled = 0;
+  };
+
+  // Every block that has been part of a snapshot since the first one, by
+  // hash. Successive snapshots share it and only add to it, so a block that
+  // was reorganized away stays in it and Find checks hits against the chain
+  // of the snapshot. Lookups take the lock shared and wait while the builder
+  // of a new snapshot adds its blocks, which are the blocks above the fork,
+  // usually one. The first snapshot adds the whole chain, before the chain
+  // is handed out to any reader.
+  class HashIndex
+  {
+  public:
+    void Add(std::span<ChainEntry const> entries);
+    [[nodiscard]] auto Get(uint256 const& hash) const -> CBlockIndex const*;
+
+  private:
+    // Block hashes are already uniformly distributed.
+    struct Hasher {
+      auto operator()(uint256 const& hash) const -> std::size_t
+      {
+        return ReadLE64(hash.begin());
+      }
+    };
+
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<uint256, CBlockIndex const*, Hasher> blocks_;
+  };
+
+  [[nodiscard]] auto Get(std::size_t height) const -> ChainEntry const&
+  {
+    return chunks_[height / chunk_size]->entries[height % chunk_size];
+  }
+
+  std::shared_ptr<HashIndex> hashes_;
+  std::vector<std::shared_ptr<Chunk>> chunks_;
+  std::size_t size_ = 0;
+};
+
+}  // namespace util
@@ -4,32 +4,35 @@
 
 #include <btck/btck.h>
 
-#include <stdlib.h>
-#include <string.h>
+#include <stddef.h>
 
-struct BtcK_Error {
-  int code;
-  char* domain;
-  char* message;
-};
+#include "alloc.h"
+#include "error.h"
 
 static struct BtcK_Error OOM_ERROR = {
   .code = -1,
+  .is_static = true,
   .domain = "Memory",
   .message = "Out of memory",
 };
 
+struct BtcK_Error* util_memory_error(void)
+{
+  return &OOM_ERROR;
+}
+
 struct BtcK_Error* BtcK_Error_New(
   int code, char const* domain, char const* message)
 {
-  struct BtcK_Error* err = malloc(sizeof(struct BtcK_Error));
+  struct BtcK_Error* err = util_malloc(sizeof(struct BtcK_Error));
   if (err == NULL) {
     return &OOM_ERROR;
   }
 
   err->code = code;
-  err->domain = domain ? strdup(domain) : NULL;
-  err->message = message ? strdup(message) : NULL;
+  err->is_static = false;
+  err->domain = domain ? util_strdup(domain) : NULL;
+  err->message = message ? util_strdup(message) : NULL;
 
   if ((domain && !err->domain) || (message && !err->message)) {
     BtcK_Error_Free(err);
@@ -41,13 +44,13 @@ struct BtcK_Error* BtcK_Error_New(
 
 void BtcK_Error_Free(struct BtcK_Error* error)
 {
-  if (error == NULL || error == &OOM_ERROR) {
+  if (error == NULL || error->is_static) {
     return;
   }
 
-  free(error->domain);
-  free(error->message);
-  free(error);
+  util_free((char*)error->domain);
+  util_free((char*)error->message);
+  util_free(error);
 }
 
 int BtcK_Error_Code(struct BtcK_Error const* error)
@@ -6,30 +6,195 @@
 
 #include <btck/btck.h>
 
+#include <btck/btck_error.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <exception>
+#include <functional>
+#include <ios>
+#include <map>
+#include <mutex>
 #include <new>
+#include <span>
+#include <string>
+#include <string_view>
 #include <system_error>
 
+#include "error.h"
+
+namespace {
+
+constexpr auto const num_verification_errors =
+  std::size_t{BtcK_VerificationError_SPENT_OUTPUTS_MISMATCH} + 1;
+
+// Covers the errno values of all common platforms.
+constexpr auto const num_errno_errors = std::size_t{256};
+
+auto VerificationError(int code) -> BtcK_Error*
+{
+  static auto errors = [] {
+    auto errors = std::array<BtcK_Error, num_verification_errors>{};
+    for (std::size_t idx = 0; idx < errors.size(); ++idx) {
+      auto const code = static_cast<BtcK_VerificationError>(idx);
+      errors[idx] = BtcK_Error{
+        .code = code,
+        .is_static = true,
+        .domain = btck::verification_error_category().name(),
+        .message = BtcK_VerificationError_Message(code),
+      };
+    }
+    return errors;
+  }();
+
+  if (code < 0 || static_cast<std::size_t>(code) >= errors.size()) {
+    return nullptr;
+  }
+  return &errors[code];
+}
+
+auto ErrnoError(int code) -> BtcK_Error*
+{
+  struct Table {
+    std::array<std::string, num_errno_errors> messages;
+    std::array<BtcK_Error, num_errno_errors> errors;
+  };
+
+  static auto table = [] {
+    auto table = Table{};
+    for (std::size_t idx = 0; idx < num_errno_errors; ++idx) {
+      auto const code = static_cast<int>(idx);
+      table.messages[idx] = std::generic_category().message(code);
+      table.errors[idx] = BtcK_Error{
+        .code = code,
+        .is_static = true,
+        .domain = std::generic_category().name(),
+        .message = table.messages[idx].c_str(),
+      };
+    }
+    return table;
+  }();
+
+  if (code < 0 || static_cast<std::size_t>(code) >= num_errno_errors) {
+    return nullptr;
+  }
+  return &table.errors[code];
+}
+
+// Parse errors from junk input carry one of the few fixed messages of the
+// serialization code, so each message is kept once and then handed out as a
+// static error without allocating. The table is bounded in case a message is
+// not fixed after all.
+auto IostreamError(int code, char const* message) -> BtcK_Error*
+{
+  constexpr auto max_errors = std::size_t{64};
+
+  struct Table {
+    std::mutex mutex;
+    std::map<std::string, BtcK_Error, std::less<>> errors;
+  };
+
+  // Leaked, so that errors handed out remain valid during static destruction.
+  static auto& table = *new Table{};
+
+  auto const lock = std::lock_guard{table.mutex};
+  auto it = table.errors.find(std::string_view{message});
+  if (it == table.errors.end()) {
+    if (table.errors.size() >= max_errors) {
+      return nullptr;
+    }
+    it = table.errors.try_emplace(message).first;
+    it->second = BtcK_Error{
+      .code = code,
+      .is_static = true,
+      .domain = std::iostream_category().name(),
+      .message = it->first.c_str(),
+    };
+  }
+  return it->second.code == code ? &it->second : nullptr;
+}
+
+// Storage behind BtcK_Error_ThreadLocal(). Each error reported to the slot
+// overwrites the previous one; long strings are truncated.
+struct ThreadLocalError {
+  BtcK_Error error;
+  std::array<char, 64> domain;
+  std::array<char, 256> message;
+};
+
+thread_local ThreadLocalError t_error = {};
+
+auto CopyTruncated(std::string_view str, std::span<char> buf) -> char const*
+{
+  auto const len = std::min(str.size(), buf.size() - 1);
+  std::copy_n(str.data(), len, buf.data());
+  buf[len] = '\0';
+  return buf.data();
+}
+
+auto MakeError(
+  BtcK_Error** err, int code, char const* domain, char const* message)
+  -> BtcK_Error*
+{
+  if (err != &util::t_error_slot) {
+    return BtcK_Error_New(code, domain, message);
+  }
+  t_error.error = BtcK_Error{
+    .code = code,
+    .is_static = true,
+    .domain = CopyTruncated(domain, t_error.domain),
+    .message = CopyTruncated(message, t_error.message),
+  };
+  return &t_error.error;
+}
+
+}  // namespace
+
 namespace util {
 
-auto TranslateException() -> BtcK_Error*
+thread_local BtcK_Error* t_error_slot = nullptr;
+
+auto TranslateException(BtcK_Error** err) -> BtcK_Error*
 {
   try {
     throw;
   }
-  catch (std::bad_alloc const& e) {
-    return BtcK_Error_New(-1, "Memory", e.what());
+  catch (std::bad_alloc const&) {
+    return util_memory_error();
   }
   catch (std::system_error const& e) {
     auto const& code = e.code();
-    return BtcK_Error_New(code.value(), code.category().name(), e.what());
+    auto* error = static_cast<BtcK_Error*>(nullptr);
+    if (code.category() == btck::verification_error_category()) {
+      error = VerificationError(code.value());
+    }
+    else if (code.category() == std::generic_category()) {
+      error = ErrnoError(code.value());
+    }
+    else if (code.category() == std::iostream_category()) {
+      error = IostreamError(code.value(), e.what());
+    }
+    if (error != nullptr) {
+      return error;
+    }
+    return MakeError(err, code.value(), code.category().name(), e.what());
   }
   catch (std::exception const& e) {
-    return BtcK_Error_New(-1, "Unknown", e.what());
+    return MakeError(err, -1, "Unknown", e.what());
   }
   catch (...) {
-    return BtcK_Error_New(-1, "Unknown", "Unknown exception");
+    return MakeError(err, -1, "Unknown", "Unknown exception");
   }
 }
 
 }  // namespace util
+
+extern "C" {
+
+auto BtcK_Error_ThreadLocal() -> BtcK_Error**
+{
+  return &util::t_error_slot;
+}
+
+}  // extern "C"
@@ -0,0 +1,25 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Static errors are preallocated and immutable; BtcK_Error_Free ignores them.
+struct BtcK_Error {
+  int code;
+  bool is_static;
+  char const* domain;
+  char const* message;
+};
+
+struct BtcK_Error* util_memory_error(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
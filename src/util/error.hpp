@@ -10,16 +10,27 @@ struct BtcK_Error;
 
 namespace util {
 
-auto TranslateException() -> BtcK_Error*;
+// The slot returned by BtcK_Error_ThreadLocal().
+extern thread_local BtcK_Error* t_error_slot;
+
+// Converts the current exception into an error for `err`. Well-known errors
+// are static singletons, other errors are allocated unless `err` is the slot
+// returned by BtcK_Error_ThreadLocal().
+auto TranslateException(BtcK_Error** err) -> BtcK_Error*;
 
 template <typename Function> auto WrapFn(BtcK_Error** err, Function&& function)
 {
+  // The slot is reused across calls, so a success must not leave the error of
+  // an earlier call behind. Other out parameters are only written on failure.
+  if (err == &t_error_slot) {
+    t_error_slot = nullptr;
+  }
   try {
     return function();
   }
   catch (...) {
     if (err != nullptr) {
-      *err = TranslateException();
+      *err = TranslateException(err);
     }
 
     using Ret = decltype(function());
@@ -0,0 +1,250 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "export.hpp"
+
+#include <btck/btck.h>
+#include <primitives/block.h>
+
+#include <serialize.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "json.hpp"
+#include "writer_stream.hpp"
+
+namespace {
+
+class WorkerThreads
+{
+public:
+  WorkerThreads() = default;
+  WorkerThreads(WorkerThreads const&) = delete;
+  auto operator=(WorkerThreads const&) -> WorkerThreads& = delete;
+
+  ~WorkerThreads()
+  {
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  template <typename Function> void Spawn(Function&& function)
+  {
+    threads_.emplace_back(std::forward<Function>(function));
+  }
+
+private:
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace
+
+namespace util {
+
+void ExportOrdered(
+  std::size_t count, std::size_t num_threads, Produce const& produce,
+  Consume const& consume)
+{
+  if (num_threads == 0) {
+    num_threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  num_threads = std::min(num_threads, count);
+
+  if (num_threads <= 1) {
+    auto buffer = std::vector<std::byte>{};
+    for (std::size_t idx = 0; idx < count; ++idx) {
+      buffer.clear();
+      produce(idx, buffer);
+      consume(idx, buffer);
+    }
+    return;
+  }
+
+  auto const window = 2 * num_threads;
+  auto slots = std::vector<std::optional<std::vector<std::byte>>>(window);
+  auto mutex = std::mutex{};
+  auto produced = std::condition_variable{};
+  auto consumed = std::condition_variable{};
+  auto claimed = std::size_t{0};
+  auto delivered = std::size_t{0};
+  auto stop = false;
+  auto exception = std::exception_ptr{};
+
+  auto const fail = [&] {
+    {
+      auto const lock = std::lock_guard{mutex};
+      if (!exception) {
+        exception = std::current_exception();
+      }
+      stop = true;
+    }
+    produced.notify_all();
+    consumed.notify_all();
+  };
+
+  auto const work = [&] {
+    while (true) {
+      auto idx = std::size_t{0};
+      {
+        auto lock = std::unique_lock{mutex};
+        consumed.wait(lock, [&] {
+          return stop || claimed == count || claimed < delivered + window;
+        });
+        if (stop || claimed == count) {
+          return;
+        }
+        idx = claimed++;
+      }
+
+      auto result = std::vector<std::byte>{};
+      try {
+        produce(idx, result);
+      }
+      catch (...) {
+        fail();
+        return;
+      }
+
+      {
+        auto const lock = std::lock_guard{mutex};
+        slots[idx % window] = std::move(result);
+      }
+      produced.notify_all();
+    }
+  };
+
+  {
+    auto threads = WorkerThreads{};
+    try {
+      for (std::size_t i = 0; i < num_threads; ++i) {
+        threads.Spawn(work);
+      }
+
+      while (delivered < count) {
+        auto result = std::vector<std::byte>{};
+        {
+          auto lock = std::unique_lock{mutex};
+          auto& slot = slots[delivered % window];
+          produced.wait(lock, [&] { return stop || slot.has_value(); });
+          if (stop) {
+            break;
+          }
+          result = *std::move(slot);
+          slot.reset();
+        }
+        consume(delivered, result);
+        {
+          auto const lock = std::lock_guard{mutex};
+          ++delivered;
+        }
+        consumed.notify_all();
+      }
+    }
+    catch (...) {
+      fail();
+    }
+  }
+
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
+void ParallelFor(
+  std::size_t count, std::size_t num_threads,
+  std::function<void(std::size_t)> const& work)
+{
+  if (num_threads == 0) {
+    num_threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  num_threads = std::min(num_threads, count);
+
+  auto next = std::atomic<std::size_t>{0};
+  auto mutex = std::mutex{};
+  auto exception = std::exception_ptr{};
+  auto const run = [&] {
+    try {
+      for (auto idx = next++; idx < count; idx = next++) {
+        work(idx);
+      }
+    }
+    catch (...) {
+      auto const lock = std::lock_guard{mutex};
+      if (!exception) {
+        exception = std::current_exception();
+      }
+      next = count;
+    }
+  };
+
+  {
+    auto threads = WorkerThreads{};
+    for (std::size_t i = 1; i < num_threads; ++i) {
+      threads.Spawn(run);
+    }
+    run();
+  }
+
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
+auto SinkConsumer(BtcK_ExportSink sink, void* userdata, std::size_t first)
+  -> Consume
+{
+  return [=](std::size_t idx, std::span<std::byte const> bytes) {
+    if (sink(first + idx, bytes.data(), bytes.size(), userdata) != 0) {
+      throw std::system_error(
+        std::make_error_code(std::errc::operation_canceled));
+    }
+  };
+}
+
+void ExportBlock(
+  CBlock const& block, BtcK_ExportFormat format, BtcK_JsonOptions options,
+  std::vector<std::byte>& out)
+{
+  constexpr auto const append = +[](void const* buf, size_t len, void* ud) {
+    auto& out = *static_cast<std::vector<std::byte>*>(ud);
+    auto const* first = static_cast<std::byte const*>(buf);
+    out.insert(out.end(), first, first + len);
+    return 0;
+  };
+
+  if (format == BtcK_ExportFormat_JSON) {
+    auto json = JsonWriter{append, &out};
+    WriteBlockJson(json, block, options);
+    json.Flush();
+  }
+  else {
+    auto stream = WriterStream{append, &out};
+    stream << TX_WITH_WITNESS(block);
+  }
+}
+
+void CheckExportFormat(BtcK_ExportFormat format, BtcK_JsonOptions options)
+{
+  if (format != BtcK_ExportFormat_BYTES && format != BtcK_ExportFormat_JSON) {
+    throw std::invalid_argument("Unknown export format.");
+  }
+  if ((options & ~BtcK_JsonOptions_ALL) != 0) {
+    throw std::invalid_argument("Unknown JSON options.");
+  }
+}
+
+}  // namespace util
@@ -0,0 +1,48 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <btck/btck.h>
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <vector>
+
+class CBlock;
+
+namespace util {
+
+using Produce = std::function<void(std::size_t, std::vector<std::byte>&)>;
+using Consume = std::function<void(std::size_t, std::span<std::byte const>)>;
+
+// Calls `produce` for every index in [0, count) on up to `num_threads` worker
+// threads and passes the results to `consume` in index order on the calling
+// thread. Only a bounded window of results is kept in memory, so a slow
+// consumer throttles the workers. The first exception stops all work and is
+// rethrown.
+void ExportOrdered(
+  std::size_t count, std::size_t num_threads, Produce const& produce,
+  Consume const& consume);
+
+// Calls `work` for every index in [0, count) on up to `num_threads` threads,
+// the calling thread included, in no particular order. The first exception
+// stops all work and is rethrown.
+void ParallelFor(
+  std::size_t count, std::size_t num_threads,
+  std::function<void(std::size_t)> const& work);
+
+// Forwards results to a C sink, shifting indices by `first`. A nonzero return
+// value from the sink cancels the export.
+auto SinkConsumer(BtcK_ExportSink sink, void* userdata, std::size_t first)
+  -> Consume;
+
+void ExportBlock(
+  CBlock const& block, BtcK_ExportFormat format, BtcK_JsonOptions options,
+  std::vector<std::byte>& out);
+
+void CheckExportFormat(BtcK_ExportFormat format, BtcK_JsonOptions options);
+
+}  // namespace util
@@ -0,0 +1,70 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "intern_table.hpp"
+
+#include <script/script.h>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+namespace util {
+
+auto ScriptHash::operator()(CScript const& script) const -> std::size_t
+{
+  return std::hash<std::string_view>{}(
+    {reinterpret_cast<char const*>(script.data()), script.size()});
+}
+
+auto InternTable::Intern(CScript const& script) -> CScript const&
+{
+  auto const lock = std::lock_guard{mutex_};
+  auto const [it, inserted] = scripts_.try_emplace(script, 0);
+  it->second += 1;
+  size_.store(scripts_.size(), std::memory_order_relaxed);
+  return it->first;
+}
+
+void InternTable::Release(CScript const& script)
+{
+  auto const lock = std::lock_guard{mutex_};
+  auto const it = scripts_.find(script);
+  if (it == scripts_.end() || &it->first != &script) {
+    return;
+  }
+  if (--it->second == 0) {
+    scripts_.erase(it);
+    size_.store(scripts_.size(), std::memory_order_relaxed);
+  }
+}
+
+auto InternTable::Share(CScript const& script)
+  -> std::shared_ptr<CScript const>
+{
+  // A script can only be interned if the table held it when the caller got
+  // it, so a stale zero means it is not.
+  if (size_.load(std::memory_order_relaxed) == 0) {
+    return nullptr;
+  }
+  {
+    auto const lock = std::lock_guard{mutex_};
+    auto const it = scripts_.find(script);
+    if (it == scripts_.end() || &it->first != &script) {
+      return nullptr;
+    }
+    it->second += 1;
+  }
+  return {&script, [this](CScript const* shared) { Release(*shared); }};
+}
+
+auto InternTable::Get() -> InternTable&
+{
+  static auto& table = *new InternTable{};
+  return table;
+}
+
+}  // namespace util
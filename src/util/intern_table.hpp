@@ -0,0 +1,47 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <script/script.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace util {
+
+struct ScriptHash {
+  auto operator()(CScript const& script) const -> std::size_t;
+};
+
+// Canonical scripts with their reference counts. The map is node based, so an
+// interned script keeps its address until the last reference is released.
+class InternTable
+{
+public:
+  auto Intern(CScript const& script) -> CScript const&;
+
+  // Scripts that did not come from Intern are left alone.
+  void Release(CScript const& script);
+
+  // Takes another reference to an interned script, released when the last
+  // copy of the pointer goes away. Null if `script` did not come from Intern.
+  [[nodiscard]] auto Share(CScript const& script)
+    -> std::shared_ptr<CScript const>;
+
+  // Leaked, so that interned scripts held by other static objects can still
+  // be released during static destruction.
+  [[nodiscard]] static auto Get() -> InternTable&;
+
+private:
+  std::mutex mutex_;
+  std::unordered_map<CScript, std::size_t, ScriptHash> scripts_;
+  // Lets Share skip the lookup while nothing is interned.
+  std::atomic<std::size_t> size_{0};
+};
+
+}  // namespace util
@@ -0,0 +1,372 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "json.hpp"
+
+#include <btck/btck.h>
+#include <consensus/amount.h>
+#include <consensus/validation.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <script/solver.h>
+
+#include <serialize.h>
+
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "writer_stream.hpp"
+
+namespace {
+
+constexpr auto const hex_digits = std::string_view{"0123456789abcdef"};
+
+auto ScriptToAsm(CScript const& script) -> std::string
+{
+  auto str = std::string{};
+  auto opcode = opcodetype{};
+  auto data = std::vector<unsigned char>{};
+  for (auto pc = script.begin(); pc < script.end();) {
+    if (!str.empty()) {
+      str += ' ';
+    }
+    if (!script.GetOp(pc, opcode, data)) {
+      str += "[error]";
+      break;
+    }
+    if (opcode > OP_PUSHDATA4) {
+      str += GetOpName(opcode);
+    }
+    else if (data.size() <= 4) {
+      str += std::to_string(CScriptNum(data, false).getint());
+    }
+    else {
+      for (auto const byte : data) {
+        str += hex_digits[byte >> 4];
+        str += hex_digits[byte & 0x0f];
+      }
+    }
+  }
+  return str;
+}
+
+void WriteScript(
+  util::JsonWriter& json, CScript const& script, BtcK_JsonOptions options,
+  bool with_type)
+{
+  json.BeginObject();
+  if ((options & BtcK_JsonOptions_DECODE_SCRIPTS) != 0) {
+    json.Key("asm").String(ScriptToAsm(script));
+  }
+  json.Key("hex").Hex(script);
+  if (with_type && (options & BtcK_JsonOptions_DECODE_SCRIPTS) != 0) {
+    auto solutions = std::vector<std::vector<unsigned char>>{};
+    json.Key("type").String(GetTxnOutputType(Solver(script, solutions)));
+  }
+  json.EndObject();
+}
+
+void WriteWitness(util::JsonWriter& json, CScriptWitness const& witness)
+{
+  json.BeginArray();
+  for (auto const& item : witness.stack) {
+    json.Hex(item);
+  }
+  json.EndArray();
+}
+
+auto GetDifficulty(std::uint32_t bits) -> double
+{
+  int shift = static_cast<int>((bits >> 24) & 0xff);
+  double diff = double{0x0000ffff} / double(bits & 0x00ffffff);
+  for (; shift < 29; ++shift) {
+    diff *= 256.0;
+  }
+  for (; shift > 29; --shift) {
+    diff /= 256.0;
+  }
+  return diff;
+}
+
+auto Hex32(std::uint32_t value) -> std::string
+{
+  auto buf = std::array<char, 9>{};
+  std::snprintf(buf.data(), buf.size(), "%08x", value);
+  return std::string{buf.data(), 8};
+}
+
+}  // namespace
+
+namespace util {
+
+void JsonWriter::BeginObject()
+{
+  BeginValue();
+  Put('{');
+  assert(depth_ < 64);
+  nonempty_ &= ~(std::uint64_t{1} << depth_);
+  ++depth_;
+}
+
+void JsonWriter::EndObject()
+{
+  --depth_;
+  Put('}');
+}
+
+void JsonWriter::BeginArray()
+{
+  BeginValue();
+  Put('[');
+  assert(depth_ < 64);
+  nonempty_ &= ~(std::uint64_t{1} << depth_);
+  ++depth_;
+}
+
+void JsonWriter::EndArray()
+{
+  --depth_;
+  Put(']');
+}
+
+auto JsonWriter::Key(std::string_view key) -> JsonWriter&
+{
+  String(key);
+  Put(':');
+  after_key_ = true;
+  return *this;
+}
+
+void JsonWriter::String(std::string_view str)
+{
+  BeginValue();
+  Put('"');
+  for (auto const c : str) {
+    switch (c) {
+      case '"':
+        Put("\\\"");
+        break;
+      case '\\':
+        Put("\\\\");
+        break;
+      case '\n':
+        Put("\\n");
+        break;
+      case '\r':
+        Put("\\r");
+        break;
+      case '\t':
+        Put("\\t");
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          Put("\\u00");
+          Put(hex_digits[static_cast<unsigned char>(c) >> 4]);
+          Put(hex_digits[static_cast<unsigned char>(c) & 0x0f]);
+        }
+        else {
+          Put(c);
+        }
+    }
+  }
+  Put('"');
+}
+
+void JsonWriter::Hex(std::span<unsigned char const> bytes)
+{
+  BeginHexString();
+  AppendHex(std::as_bytes(bytes));
+  EndHexString();
+}
+
+void JsonWriter::Double(double value)
+{
+  BeginValue();
+  if (!std::isfinite(value)) {
+    Put("null");
+    return;
+  }
+  auto buf = std::array<char, 32>{};
+  auto const result = std::to_chars(buf.data(), buf.data() + buf.size(), value);
+  Put(std::string_view{buf.data(), result.ptr});
+}
+
+void JsonWriter::Amount(std::int64_t amount)
+{
+  BeginValue();
+  auto const abs = (amount < 0) ? -static_cast<std::uint64_t>(amount)
+                                 : static_cast<std::uint64_t>(amount);
+  auto buf = std::array<char, 32>{};
+  auto const len = std::snprintf(
+    buf.data(), buf.size(), "%s%llu.%08llu", (amount < 0) ? "-" : "",
+    static_cast<unsigned long long>(abs / COIN),
+    static_cast<unsigned long long>(abs % COIN));
+  Put(std::string_view{buf.data(), static_cast<std::size_t>(len)});
+}
+
+void JsonWriter::BeginHexString()
+{
+  BeginValue();
+  Put('"');
+}
+
+void JsonWriter::AppendHex(std::span<std::byte const> bytes)
+{
+  for (auto const byte : bytes) {
+    auto const value = std::to_integer<unsigned char>(byte);
+    Put(hex_digits[value >> 4]);
+    Put(hex_digits[value & 0x0f]);
+  }
+}
+
+void JsonWriter::EndHexString()
+{
+  Put('"');
+}
+
+void JsonWriter::Flush()
+{
+  if (size_ != 0 && write_(buffer_.data(), size_, userdata_) != 0) {
+    throw std::system_error(std::make_error_code(std::errc::io_error));
+  }
+  size_ = 0;
+}
+
+void JsonWriter::BeginValue()
+{
+  if (after_key_) {
+    after_key_ = false;
+    return;
+  }
+  if (depth_ == 0) {
+    return;
+  }
+  auto const bit = std::uint64_t{1} << (depth_ - 1);
+  if ((nonempty_ & bit) != 0) {
+    Put(',');
+  }
+  nonempty_ |= bit;
+}
+
+void JsonWriter::Put(char c)
+{
+  if (size_ == buffer_.size()) {
+    Flush();
+  }
+  buffer_[size_++] = c;
+}
+
+void JsonWriter::Put(std::string_view str)
+{
+  for (auto const c : str) {
+    Put(c);
+  }
+}
+
+void WriteTransactionJson(
+  JsonWriter& json, CTransaction const& tx, BtcK_JsonOptions options)
+{
+  auto const weight = GetTransactionWeight(tx);
+
+  json.BeginObject();
+  json.Key("txid").String(tx.GetHash().GetHex());
+  json.Key("hash").String(tx.GetWitnessHash().GetHex());
+  json.Key("version").Number(tx.version);
+  json.Key("size").Number(::GetSerializeSize(TX_WITH_WITNESS(tx)));
+  json.Key("vsize").Number(
+    (weight + WITNESS_SCALE_FACTOR - 1) / WITNESS_SCALE_FACTOR);
+  json.Key("weight").Number(weight);
+  json.Key("locktime").Number(tx.nLockTime);
+
+  json.Key("vin").BeginArray();
+  for (auto const& txin : tx.vin) {
+    json.BeginObject();
+    if (tx.IsCoinBase()) {
+      json.Key("coinbase").Hex(txin.scriptSig);
+    }
+    else {
+      json.Key("txid").String(txin.prevout.hash.GetHex());
+      json.Key("vout").Number(txin.prevout.n);
+      json.Key("scriptSig");
+      WriteScript(json, txin.scriptSig, options, false);
+    }
+    if ((options & BtcK_JsonOptions_WITNESS) != 0 &&
+        !txin.scriptWitness.IsNull()) {
+      json.Key("txinwitness");
+      WriteWitness(json, txin.scriptWitness);
+    }
+    json.Key("sequence").Number(txin.nSequence);
+    json.EndObject();
+  }
+  json.EndArray();
+
+  json.Key("vout").BeginArray();
+  for (std::size_t n = 0; n < tx.vout.size(); ++n) {
+    json.BeginObject();
+    json.Key("value").Amount(tx.vout[n].nValue);
+    json.Key("n").Number(n);
+    json.Key("scriptPubKey");
+    WriteScript(json, tx.vout[n].scriptPubKey, options, true);
+    json.EndObject();
+  }
+  json.EndArray();
+
+  if ((options & BtcK_JsonOptions_TX_HEX) != 0) {
+    json.Key("hex").BeginHexString();
+    constexpr auto const append = +[](void const* buf, size_t len, void* ud) {
+      auto& json = *static_cast<JsonWriter*>(ud);
+      json.AppendHex(std::span{static_cast<std::byte const*>(buf), len});
+      return 0;
+    };
+    auto stream = WriterStream{append, &json};
+    SerializeTransaction(tx, stream, TX_WITH_WITNESS);
+    json.EndHexString();
+  }
+  json.EndObject();
+}
+
+void WriteBlockJson(
+  JsonWriter& json, CBlock const& block, BtcK_JsonOptions options)
+{
+  json.BeginObject();
+  json.Key("hash").String(block.GetHash().GetHex());
+  json.Key("version").Number(block.nVersion);
+  json.Key("versionHex").String(Hex32(block.nVersion));
+  json.Key("merkleroot").String(block.hashMerkleRoot.GetHex());
+  json.Key("time").Number(block.nTime);
+  json.Key("nonce").Number(block.nNonce);
+  json.Key("bits").String(Hex32(block.nBits));
+  json.Key("difficulty").Double(GetDifficulty(block.nBits));
+  json.Key("nTx").Number(block.vtx.size());
+  if (!block.hashPrevBlock.IsNull()) {
+    json.Key("previousblockhash").String(block.hashPrevBlock.GetHex());
+  }
+  json.Key("strippedsize").Number(::GetSerializeSize(TX_NO_WITNESS(block)));
+  json.Key("size").Number(::GetSerializeSize(TX_WITH_WITNESS(block)));
+  json.Key("weight").Number(GetBlockWeight(block));
+
+  json.Key("tx").BeginArray();
+  for (auto const& tx : block.vtx) {
+    if ((options & BtcK_JsonOptions_VERBOSE) != 0) {
+      WriteTransactionJson(json, *tx, options);
+    }
+    else {
+      json.String(tx->GetHash().GetHex());
+    }
+  }
+  json.EndArray();
+  json.EndObject();
+}
+
+}  // namespace util
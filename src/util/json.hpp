@@ -0,0 +1,82 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <btck/btck.h>
+
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+class CBlock;
+class CTransaction;
+
+namespace util {
+
+// Streams JSON through a BtcK_WriteBytes callback. Output is collected in a
+// small fixed-size buffer that is flushed whenever it fills up, so the size of
+// the document does not affect memory usage.
+class JsonWriter
+{
+public:
+  JsonWriter(BtcK_WriteBytes write, void* userdata)
+    : write_{write}
+    , userdata_{userdata}
+  {}
+
+  void BeginObject();
+  void EndObject();
+  void BeginArray();
+  void EndArray();
+
+  auto Key(std::string_view key) -> JsonWriter&;
+
+  void String(std::string_view str);
+  void Hex(std::span<unsigned char const> bytes);
+  void Double(double value);
+  void Amount(std::int64_t amount);
+
+  template <std::integral T> void Number(T value)
+  {
+    BeginValue();
+    auto buf = std::array<char, 24>{};
+    auto const result =
+      std::to_chars(buf.data(), buf.data() + buf.size(), value);
+    Put(std::string_view{buf.data(), result.ptr});
+  }
+
+  // A hex string value whose content is appended in pieces, for example by
+  // a serializer.
+  void BeginHexString();
+  void AppendHex(std::span<std::byte const> bytes);
+  void EndHexString();
+
+  void Flush();
+
+private:
+  void BeginValue();
+  void Put(char c);
+  void Put(std::string_view str);
+
+  BtcK_WriteBytes write_;
+  void* userdata_;
+  std::array<char, 4096> buffer_;
+  std::size_t size_ = 0;
+  std::uint64_t nonempty_ = 0;  // one bit per nesting level
+  unsigned int depth_ = 0;
+  bool after_key_ = false;
+};
+
+void WriteTransactionJson(
+  JsonWriter& json, CTransaction const& tx, BtcK_JsonOptions options);
+
+void WriteBlockJson(
+  JsonWriter& json, CBlock const& block, BtcK_JsonOptions options);
+
+}  // namespace util
@@ -0,0 +1,130 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "memory_stats.hpp"
+
+#include <btck/btck.h>  // IWYU pragma: associated
+
+#include <core_memusage.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+#include "output.hpp"
+
+#ifdef BTCK_ENABLE_MEMORY_STATS
+namespace {
+
+struct Counters {
+  std::atomic<std::size_t> objects{0};
+  std::atomic<std::size_t> bytes{0};
+};
+
+constexpr auto const num_types = std::size_t{BtcK_ObjectType_FLAT_BLOCK} + 1;
+
+auto g_counters = std::array<Counters, num_types>{};
+
+}  // namespace
+#endif
+
+namespace util {
+
+auto DynamicMemoryUsage(CScript const& script) -> std::size_t
+{
+  return RecursiveDynamicUsage(script);
+}
+
+auto DynamicMemoryUsage(CTxOut const& txout) -> std::size_t
+{
+  return RecursiveDynamicUsage(txout);
+}
+
+auto DynamicMemoryUsage(SharedOutput const& output) -> std::size_t
+{
+  return RecursiveDynamicUsage(*output.script);
+}
+
+auto DynamicMemoryUsage(CTransactionRef const& tx) -> std::size_t
+{
+  return RecursiveDynamicUsage(tx);
+}
+
+auto DynamicMemoryUsage(CBlockRef const& block) -> std::size_t
+{
+  return RecursiveDynamicUsage(block);
+}
+
+auto PayloadUsage(CTransaction const& tx) -> std::size_t
+{
+  return RecursiveDynamicUsage(tx);
+}
+
+auto PayloadUsage(CBlock const& block) -> std::size_t
+{
+  return RecursiveDynamicUsage(block);
+}
+
+void MemoryStats::Add(
+  [[maybe_unused]] BtcK_ObjectType type,
+  [[maybe_unused]] std::size_t bytes) noexcept
+{
+#ifdef BTCK_ENABLE_MEMORY_STATS
+  auto& counters = g_counters[type];
+  counters.objects.fetch_add(1, std::memory_order_relaxed);
+  counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+#endif
+}
+
+void MemoryStats::Remove(
+  [[maybe_unused]] BtcK_ObjectType type,
+  [[maybe_unused]] std::size_t bytes) noexcept
+{
+#ifdef BTCK_ENABLE_MEMORY_STATS
+  auto& counters = g_counters[type];
+  counters.objects.fetch_sub(1, std::memory_order_relaxed);
+  counters.bytes.fetch_sub(bytes, std::memory_order_relaxed);
+#endif
+}
+
+void MemoryStats::AddBytes(
+  [[maybe_unused]] BtcK_ObjectType type,
+  [[maybe_unused]] std::size_t bytes) noexcept
+{
+#ifdef BTCK_ENABLE_MEMORY_STATS
+  g_counters[type].bytes.fetch_add(bytes, std::memory_order_relaxed);
+#endif
+}
+
+void MemoryStats::RemoveBytes(
+  [[maybe_unused]] BtcK_ObjectType type,
+  [[maybe_unused]] std::size_t bytes) noexcept
+{
+#ifdef BTCK_ENABLE_MEMORY_STATS
+  g_counters[type].bytes.fetch_sub(bytes, std::memory_order_relaxed);
+#endif
+}
+
+}  // namespace util
+
+extern "C" {
+
+auto BtcK_GetMemoryStats(BtcK_ObjectType type, BtcK_MemoryStats* out) -> int
+{
+#ifdef BTCK_ENABLE_MEMORY_STATS
+  if (type >= num_types) {
+    return -1;
+  }
+  auto const& counters = g_counters[type];
+  out->live_objects = counters.objects.load(std::memory_order_relaxed);
+  out->live_bytes = counters.bytes.load(std::memory_order_relaxed);
+  return 0;
+#else
+  static_cast<void>(type);
+  static_cast<void>(out);
+  return -1;
+#endif
+}
+
+}  // extern "C"
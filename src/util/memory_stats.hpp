@@ -0,0 +1,141 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <btck/btck.h>
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "type_mapping.hpp"
+
+namespace util {
+
+// Heap memory owned by an object, not counting the object itself. Data that
+// is shared between copies is counted in full for each of them.
+auto DynamicMemoryUsage(CScript const& script) -> std::size_t;
+auto DynamicMemoryUsage(CTxOut const& txout) -> std::size_t;
+auto DynamicMemoryUsage(SharedOutput const& output) -> std::size_t;
+auto DynamicMemoryUsage(CTransactionRef const& tx) -> std::size_t;
+auto DynamicMemoryUsage(CBlockRef const& block) -> std::size_t;
+
+// Heap memory of the object behind a shared handle.
+auto PayloadUsage(CTransaction const& tx) -> std::size_t;
+auto PayloadUsage(CBlock const& block) -> std::size_t;
+
+template <typename T> struct object_type;
+
+template <> struct object_type<CScript> {
+  static constexpr auto value = BtcK_ObjectType_SCRIPT_PUBKEY;
+};
+
+template <> struct object_type<CTxOut> {
+  static constexpr auto value = BtcK_ObjectType_TRANSACTION_OUTPUT;
+};
+
+template <> struct object_type<SharedOutput> {
+  static constexpr auto value = BtcK_ObjectType_TRANSACTION_OUTPUT;
+};
+
+template <> struct object_type<CTransactionRef> {
+  static constexpr auto value = BtcK_ObjectType_TRANSACTION;
+};
+
+template <> struct object_type<CBlockRef> {
+  static constexpr auto value = BtcK_ObjectType_BLOCK;
+};
+
+template <typename T>
+concept tracked_type = requires { object_type<T>::value; };
+
+// Handles that share their data with other handles. The data is counted once,
+// by MakeShared, so each handle only counts itself.
+template <typename T> constexpr bool shared_type = false;
+template <> constexpr bool shared_type<CTransactionRef> = true;
+template <> constexpr bool shared_type<CBlockRef> = true;
+template <> constexpr bool shared_type<SharedOutput> = true;
+
+// Process wide count of live objects and the memory they hold, per type. The
+// counters are only maintained with BTCK_ENABLE_MEMORY_STATS, because
+// measuring an object walks all of its data.
+class MemoryStats
+{
+public:
+  template <typename T> static void Track([[maybe_unused]] T const& obj)
+  {
+#ifdef BTCK_ENABLE_MEMORY_STATS
+    if constexpr (tracked_type<T>) {
+      Add(object_type<T>::value, Usage(obj));
+    }
+#endif
+  }
+
+  template <typename T> static void Untrack([[maybe_unused]] T const& obj)
+  {
+#ifdef BTCK_ENABLE_MEMORY_STATS
+    if constexpr (tracked_type<T>) {
+      Remove(object_type<T>::value, Usage(obj));
+    }
+#endif
+  }
+
+  static void Add(BtcK_ObjectType type, std::size_t bytes) noexcept;
+  static void Remove(BtcK_ObjectType type, std::size_t bytes) noexcept;
+
+  // Counts memory without counting an object, for shared data.
+  static void AddBytes(BtcK_ObjectType type, std::size_t bytes) noexcept;
+  static void RemoveBytes(BtcK_ObjectType type, std::size_t bytes) noexcept;
+
+private:
+  template <typename T> static auto Usage(T const& obj) -> std::size_t
+  {
+    if constexpr (shared_type<T>) {
+      return sizeof(T);
+    }
+    else {
+      return sizeof(T) + DynamicMemoryUsage(obj);
+    }
+  }
+};
+
+// A T whose memory is counted for as long as it lives.
+template <typename T> class Counted
+{
+public:
+  template <typename... Args>
+  explicit Counted(Args&&... args)
+    : value(std::forward<Args>(args)...),
+      bytes_{sizeof(T) + PayloadUsage(value)}
+  {
+    MemoryStats::AddBytes(type, bytes_);
+  }
+
+  Counted(Counted const&) = delete;
+  auto operator=(Counted const&) -> Counted& = delete;
+  ~Counted() { MemoryStats::RemoveBytes(type, bytes_); }
+
+  T const value;
+
+private:
+  static constexpr auto type = object_type<std::shared_ptr<T const>>::value;
+
+  std::size_t bytes_;
+};
+
+// Shares a new T whose memory is counted once, however many handles refer to
+// it. The object must not change afterwards.
+template <typename T, typename... Args>
+auto MakeShared(Args&&... args) -> std::shared_ptr<T const>
+{
+#ifdef BTCK_ENABLE_MEMORY_STATS
+  auto counted = std::make_shared<Counted<T>>(std::forward<Args>(args)...);
+  return {counted, &counted->value};
+#else
+  return std::make_shared<T const>(std::forward<Args>(args)...);
+#endif
+}
+
+}  // namespace util
@@ -0,0 +1,78 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <btck/btck.h>
+#include <consensus/amount.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace util {
+
+// An output whose script is owned elsewhere, by a transaction through the
+// aliasing constructor of shared_ptr or by the intern table.
+struct SharedOutput {
+  CAmount amount;
+  std::shared_ptr<CScript const> script;
+};
+
+// Output handles point at a CTxOut, or at a SharedOutput with the lowest bit
+// of the pointer set. Outputs borrowed from transactions and undo data are
+// always CTxOuts, owned outputs may be either.
+class OutputRef
+{
+public:
+  explicit OutputRef(BtcK_TransactionOutput const* handle)
+    : bits_{reinterpret_cast<std::uintptr_t>(handle)}
+  {}
+
+  [[nodiscard]] auto IsShared() const -> bool
+  {
+    return (bits_ & shared_bit) != 0;
+  }
+
+  [[nodiscard]] auto TxOut() const -> CTxOut&
+  {
+    return *reinterpret_cast<CTxOut*>(bits_);
+  }
+
+  [[nodiscard]] auto Shared() const -> SharedOutput&
+  {
+    return *reinterpret_cast<SharedOutput*>(bits_ & ~shared_bit);
+  }
+
+  [[nodiscard]] auto Amount() const -> CAmount
+  {
+    return IsShared() ? Shared().amount : TxOut().nValue;
+  }
+
+  [[nodiscard]] auto Script() const -> CScript const&
+  {
+    return IsShared() ? *Shared().script : TxOut().scriptPubKey;
+  }
+
+  // Copies the script of a shared output, for code that needs a CTxOut.
+  [[nodiscard]] auto ToTxOut() const -> CTxOut
+  {
+    return IsShared() ? CTxOut{Shared().amount, *Shared().script} : TxOut();
+  }
+
+  [[nodiscard]] static auto Tag(BtcK_TransactionOutput* shared)
+    -> BtcK_TransactionOutput*
+  {
+    return reinterpret_cast<BtcK_TransactionOutput*>(
+      reinterpret_cast<std::uintptr_t>(shared) | shared_bit);
+  }
+
+private:
+  static constexpr auto shared_bit = std::uintptr_t{1};
+
+  std::uintptr_t bits_;
+};
+
+}  // namespace util
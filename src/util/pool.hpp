@@ -0,0 +1,95 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#include "alloc.h"
+
+namespace util {
+
+// Storage for objects of type T. With BTCK_ENABLE_POOLS, freed storage is kept
+// on a per-thread free list and handed out again by the next allocation on the
+// same thread, which avoids the global allocator and its locks for the small
+// handle types. Storage may be freed on a different thread than the one that
+// allocated it; it then simply migrates to that thread's list.
+template <typename T> class Pool
+{
+public:
+  static constexpr std::size_t max_cached = 1024;
+
+  [[nodiscard]] static auto Allocate() -> void*
+  {
+#ifdef BTCK_ENABLE_POOLS
+    auto* cache = GetCache();
+    if (cache != nullptr && cache->head != nullptr) {
+      auto* node = cache->head;
+      cache->head = node->next;
+      cache->size -= 1;
+      return node;
+    }
+#endif
+    auto* ptr = util_malloc(sizeof(T));
+    if (ptr == nullptr) {
+      throw std::bad_alloc();
+    }
+    return ptr;
+  }
+
+  static void Deallocate(void* ptr) noexcept
+  {
+#ifdef BTCK_ENABLE_POOLS
+    auto* cache = GetCache();
+    if (cache != nullptr && cache->size < max_cached) {
+      cache->head = ::new (ptr) Node{cache->head};
+      cache->size += 1;
+      return;
+    }
+#endif
+    util_free(ptr);
+  }
+
+private:
+  struct Node {
+    Node* next;
+  };
+
+  static_assert(sizeof(T) >= sizeof(Node));
+  static_assert(alignof(T) >= alignof(Node));
+
+  struct Cache {
+    Cache() = default;
+    Cache(Cache const&) = delete;
+    auto operator=(Cache const&) -> Cache& = delete;
+
+    ~Cache()
+    {
+      destroyed = true;
+      while (head != nullptr) {
+        util_free(std::exchange(head, head->next));
+      }
+    }
+
+    Node* head = nullptr;
+    std::size_t size = 0;
+  };
+
+  // Objects may still be freed by thread_local destructors that run after the
+  // cache is gone. Those bypass the cache.
+  static inline thread_local bool destroyed = false;
+
+  static auto GetCache() -> Cache*
+  {
+    if (destroyed) {
+      return nullptr;
+    }
+    thread_local auto cache = Cache{};
+    return &cache;
+  }
+};
+
+}  // namespace util
@@ -0,0 +1,60 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <serialize.h>
+
+#include <cstddef>
+#include <cstring>
+#include <ios>
+#include <span>
+
+namespace util {
+
+class ReaderStream
+{
+public:
+  explicit ReaderStream(std::span<std::byte const> data)
+    : data_{data}
+  {}
+
+  void read(std::span<std::byte> buffer)
+  {
+    if (buffer.size() > data_.size()) {
+      throw std::ios_base::failure("ReaderStream::read(): end of data");
+    }
+    if (!buffer.empty()) {
+      std::memcpy(buffer.data(), data_.data(), buffer.size());
+    }
+    data_ = data_.subspan(buffer.size());
+  }
+
+  void ignore(std::size_t size) { substream(size); }
+
+  // Split off the next `size` bytes as a stream of their own.
+  auto substream(std::size_t size) -> ReaderStream
+  {
+    if (size > data_.size()) {
+      throw std::ios_base::failure("ReaderStream::substream(): end of data");
+    }
+    auto const head = data_.first(size);
+    data_ = data_.subspan(size);
+    return ReaderStream{head};
+  }
+
+  [[nodiscard]] auto size() const -> std::size_t { return data_.size(); }
+  [[nodiscard]] auto empty() const -> bool { return data_.empty(); }
+
+  template <typename T> auto operator>>(T&& obj) -> ReaderStream&
+  {
+    ::Unserialize(*this, obj);
+    return (*this);
+  }
+
+private:
+  std::span<std::byte const> data_;
+};
+
+}  // namespace util
@@ -7,6 +7,13 @@
 #include <btck/btck.h>
 #include <primitives/block.h>
 
+#include <memory>
+
+namespace util {
+class Arena;
+struct SharedOutput;
+}  // namespace util
+
 namespace api {
 
 template <typename T> struct c_to_cpp;
@@ -23,6 +30,9 @@ template <cpp_type T> using c_type_t = cpp_to_c<T>::type;
 
 }  // namespace api
 
+// Blocks are immutable once created, so copies share a single instance.
+using CBlockRef = std::shared_ptr<CBlock const>;
+
 #define UTIL_TYPE_PAIR(C, CXX)                                                 \
   template <> struct api::c_to_cpp<C> {                                        \
     using type = CXX;                                                          \
@@ -31,7 +41,16 @@ template <cpp_type T> using c_type_t = cpp_to_c<T>::type;
     using type = C;                                                            \
   }
 
-UTIL_TYPE_PAIR(BtcK_Block, CBlock);
+UTIL_TYPE_PAIR(BtcK_Arena, util::Arena);
+UTIL_TYPE_PAIR(BtcK_Block, CBlockRef);
 UTIL_TYPE_PAIR(BtcK_Transaction, CTransactionRef);
-UTIL_TYPE_PAIR(BtcK_TransactionOutput, CTxOut);
 UTIL_TYPE_PAIR(BtcK_ScriptPubkey, CScript);
+
+// Output handles hold one of two types, see util/output.hpp, so they can be
+// created from either but not read back with get().
+template <> struct api::cpp_to_c<CTxOut> {
+  using type = BtcK_TransactionOutput;
+};
+template <> struct api::cpp_to_c<util::SharedOutput> {
+  using type = BtcK_TransactionOutput;
+};
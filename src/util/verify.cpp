@@ -0,0 +1,30 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "verify.hpp"
+
+#include <script/interpreter.h>
+
+#include <btck/btck_error.hpp>
+#include <system_error>
+
+namespace util {
+
+void CheckVerificationFlags(BtcK_VerificationFlags flags)
+{
+  if ((flags & ~BtcK_VerificationFlags_ALL) != 0) {
+    throw std::system_error(btck::verification_error::invalid_flags);
+  }
+
+  bool const cleanstack = (flags & SCRIPT_VERIFY_CLEANSTACK) != 0;
+  bool const p2sh = (flags & SCRIPT_VERIFY_P2SH) != 0;
+  bool const witness = (flags & SCRIPT_VERIFY_WITNESS) != 0;
+
+  if ((cleanstack && !p2sh && !witness) || (witness && !p2sh)) {
+    throw std::system_error(
+      btck::verification_error::invalid_flags_combination);
+  }
+}
+
+}  // namespace util
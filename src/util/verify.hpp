@@ -0,0 +1,15 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <btck/btck.h>
+
+namespace util {
+
+// Throws a verification error for unknown flags and for combinations that
+// script verification does not support.
+void CheckVerificationFlags(BtcK_VerificationFlags flags);
+
+}  // namespace util
@@ -53,13 +53,39 @@ static void test_transaction(void** state)
     BtcK_Transaction_GetOutput(transaction, 1);
   assert_int_equal(BtcK_TransactionOutput_GetAmount(txout2), 42130042);
 
+  _Alignas(max_align_t) unsigned char storage[64];
+  assert_true(BtcK_TransactionOutput_SizeOf() <= sizeof(storage));
+  assert_true(BtcK_TransactionOutput_AlignOf() <= _Alignof(max_align_t));
+  struct BtcK_TransactionOutput* inplace =
+    BtcK_TransactionOutput_CopyAt(storage, txout2, NULL);
+  assert_ptr_equal(inplace, (void*)storage);
+  assert_int_equal(BtcK_TransactionOutput_GetAmount(inplace), 42130042);
+  BtcK_TransactionOutput_Destroy(inplace);
+
   BtcK_Transaction_Free(transaction);
 }
 
+static void test_thread_local_error(void** state)
+{
+  uint8_t const data[] = {0x02, 0x00};
+
+  struct BtcK_Error** slot = BtcK_Error_ThreadLocal();
+  struct BtcK_Transaction* transaction =
+    BtcK_Transaction_New(data, sizeof(data), slot);
+  assert_null(transaction);
+  assert_non_null(*slot);
+  assert_non_null(BtcK_Error_Message(*slot));
+
+  // The error lives in thread-local storage, freeing it is a no-op.
+  BtcK_Error_Free(*slot);
+  assert_non_null(BtcK_Error_Domain(*slot));
+}
+
 int main(void)
 {
   struct CMUnitTest const tests[] = {
     cmocka_unit_test(test_transaction),
+    cmocka_unit_test(test_thread_local_error),
   };
 
   return cmocka_run_group_tests(tests, NULL, NULL);
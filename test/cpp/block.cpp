@@ -5,10 +5,17 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <btck/btck.hpp>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
+#include <optional>
 #include <span>
 #include <string>
+#include <vector>
+
+#include "regtest.hpp"
 
 TEST(Block, Genesis)
 {
@@ -101,4 +108,238 @@ TEST(Block, Genesis)
   EXPECT_EQ(
     to_string(txout),
     "CTxOut(nValue=50.00000000, scriptPubKey=4104678afdb0fe5548271967f1a671)");
+
+  auto const columns = export_columns(block);
+  EXPECT_THAT(columns.amounts, ::testing::ElementsAre(50'00000000));
+  EXPECT_THAT(columns.script_offsets, ::testing::ElementsAre(0, 67));
+  EXPECT_THAT(
+    columns.script_data,
+    ::testing::ElementsAreArray(as_bytes(std::span{script_pubkey})));
+  EXPECT_THAT(columns.tx_index, ::testing::ElementsAre(0));
+  EXPECT_THAT(columns.output_index, ::testing::ElementsAre(0));
+
+  // One offset per output does not fit, the end of the last script is missing.
+  auto offsets = std::uint32_t{};
+  auto short_columns = BtcK_BlockColumns{
+    .num_outputs = 1,
+    .script_offsets_len = 1,
+    .script_data_len = 67,
+    .amounts = nullptr,
+    .script_offsets = &offsets,
+    .script_data = nullptr,
+    .tx_index = nullptr,
+    .output_index = nullptr,
+  };
+  EXPECT_EQ(BtcK_Block_ExportColumns(block.get(), &short_columns), -1);
+  EXPECT_EQ(short_columns.script_offsets_len, 2);
+
+  auto const json = to_json(block);
+  EXPECT_THAT(
+    json,
+    ::testing::StartsWith(
+      R"({"hash":"0f9188f13cb7b2c71f2a335e3a4fc328bf5beb436012afca590b1a11466e2206",)"
+      R"("version":1,"versionHex":"00000001",)"
+      R"("merkleroot":"4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b",)"
+      R"("time":1296688602,"nonce":2,"bits":"207fffff","difficulty":)"));
+  EXPECT_THAT(
+    json,
+    ::testing::EndsWith(
+      R"("nTx":1,"strippedsize":285,"size":285,"weight":1140,)"
+      R"("tx":["4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b"]})"));
+
+  EXPECT_EQ(
+    to_json(tx, btck::json_options::decode_scripts),
+    R"({"txid":"4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b",)"
+    R"("hash":"4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b",)"
+    R"("version":1,"size":204,"vsize":204,"weight":816,"locktime":0,)"
+    R"("vin":[{"coinbase":"04ffff001d0104455468652054696d65732030332f4a616e2f32303039204368616e63656c6c6f72206f6e206272696e6b206f66207365636f6e64206261696c6f757420666f722062616e6b73",)"
+    R"("sequence":4294967295}],)"
+    R"("vout":[{"value":50.00000000,"n":0,"scriptPubKey":{)"
+    R"("asm":"04678afdb0fe5548271967f1a67130b7105cd6a828e03909a67962e0ea1f61deb649f6bc3f4cef38c4f35504e51ec112de5c384df7ba0b8d578a4c702b6bf11d5f OP_CHECKSIG",)"
+    R"("hex":"4104678afdb0fe5548271967f1a67130b7105cd6a828e03909a67962e0ea1f61deb649f6bc3f4cef38c4f35504e51ec112de5c384df7ba0b8d578a4c702b6bf11d5fac",)"
+    R"("type":"pubkey"}}]})");
+
+  EXPECT_THAT(
+    to_json(block, btck::json_options::verbose),
+    ::testing::HasSubstr(
+      R"("tx":[{"txid":"4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b",)"));
+
+  auto const copy = block;
+  EXPECT_EQ(copy.hash(), block.hash());
+  EXPECT_EQ(
+    copy.transactions().front().get(), block.transactions().front().get());
+
+  auto shared = std::optional<btck::transaction>{};
+  {
+    auto const temporary = btck::block{as_bytes(std::span{block_data})};
+    shared = temporary.transactions().share(0);
+  }
+  EXPECT_EQ(to_bytes(*shared), to_bytes(tx));
+
+  {
+    auto arena = btck::arena{};
+    auto const arena_block = arena.make_block(as_bytes(std::span{block_data}));
+    EXPECT_EQ(arena_block.hash(), block.hash());
+    EXPECT_EQ(arena.copy(txout).amount(), 50'00000000);
+    auto const owned = btck::block{arena_block};
+    arena.reset();
+    EXPECT_EQ(owned.hash(), block.hash());
+  }
+
+  auto const blocks = std::vector{block, block, block};
+  auto exported = std::vector<std::size_t>{};
+  btck::export_blocks(
+    blocks,
+    [&](std::size_t idx, std::span<std::byte const> bytes) {
+      exported.push_back(idx);
+      EXPECT_TRUE(std::ranges::equal(bytes, as_bytes(std::span{block_data})));
+    },
+    btck::export_format::bytes, btck::json_options::none, 2);
+  EXPECT_THAT(exported, ::testing::ElementsAre(0, 1, 2));
+
+  auto archive = std::vector<std::byte>{};
+  auto writer = btck::archive_writer{[&](std::span<std::byte const> bytes) {
+    archive.insert(archive.end(), bytes.begin(), bytes.end());
+  }};
+  writer.append(block);
+  writer.append(block);
+
+  // An output script above MAX_SCRIPT_SIZE has to survive the archive as is,
+  // stored inline the first time and in the dictionary the second time.
+  auto const genesis_bytes = as_bytes(std::span{block_data});
+  auto const script_end = genesis_bytes.end() - 4;
+  auto oversized_data = std::vector<std::byte>(
+    genesis_bytes.begin(), script_end - 1 - std::size(script_pubkey));
+  for (auto const size_byte : {0xfd, 0xe0, 0x2e}) {
+    oversized_data.push_back(static_cast<std::byte>(size_byte));
+  }
+  oversized_data.insert(oversized_data.end(), 12'000, std::byte{0x6a});
+  oversized_data.insert(oversized_data.end(), script_end, genesis_bytes.end());
+  auto const oversized = btck::block{oversized_data};
+  writer.append(oversized);
+  writer.append(oversized);
+  writer.finish();
+
+  auto const reader = btck::archive_reader{archive};
+  EXPECT_EQ(reader.size(), 4);
+  for (auto const& archived : {reader[0], reader[1]}) {
+    EXPECT_EQ(archived.hash(), block.hash());
+    EXPECT_THAT(
+      to_bytes(archived), ::testing::ElementsAreArray(genesis_bytes));
+  }
+  for (auto const& archived : {reader[2], reader[3]}) {
+    EXPECT_THAT(
+      to_bytes(archived), ::testing::ElementsAreArray(oversized_data));
+    EXPECT_EQ(to_json(archived), to_json(oversized));
+    EXPECT_NE(to_json(archived), to_json(block));
+  }
+
+  auto const flat = btck::flat_block{as_bytes(std::span{block_data})};
+  EXPECT_EQ(flat.hash(), block.hash());
+  EXPECT_EQ(flat.count_transactions(), 1);
+  EXPECT_EQ(flat.first_output(1), 1);
+  auto const flat_copy = flat;
+  for (auto const& output : flat_copy.outputs()) {
+    EXPECT_EQ(output.amount, 50'00000000);
+    EXPECT_TRUE(std::ranges::equal(
+      output.script_pubkey, as_bytes(std::span{script_pubkey})));
+  }
+  EXPECT_EQ(btck::flat_block{block}.hash(), block.hash());
+  EXPECT_EQ(to_bytes(flat.to_block()), to_bytes(block));
+
+  auto const interned = btck::interned<btck::script_pubkey>{
+    btck::script_pubkey{as_bytes(std::span{script_pubkey})}};
+  auto const canonical =
+    btck::interned<btck::script_pubkey>{txout.script_pubkey()};
+  EXPECT_EQ(interned.get(), canonical.get());
+  EXPECT_EQ(interned, canonical);
+  EXPECT_EQ(interned, txout.script_pubkey());
+
+  // Releasing a script that was never interned leaves the table alone.
+  auto const plain = btck::script_pubkey{as_bytes(std::span{script_pubkey})};
+  BtcK_ScriptPubkey_Release(plain.get());
+  EXPECT_EQ(
+    btck::interned<btck::script_pubkey>{plain}.get(), canonical.get());
+
+  auto const interned_output = btck::transaction_output{50'00000000, canonical};
+  EXPECT_EQ(interned_output.script_pubkey().get(), canonical.get());
+  auto const interned_copy = interned_output;
+  EXPECT_EQ(interned_copy.script_pubkey().get(), canonical.get());
+  EXPECT_EQ(compress(interned_output), compress(txout));
+  EXPECT_NE(
+    btck::transaction_output(50'00000000, plain).script_pubkey().get(),
+    plain.get());
+
+  EXPECT_GT(dynamic_memory_usage(block), dynamic_memory_usage(tx));
+  EXPECT_GT(dynamic_memory_usage(flat), 0);
+  if (auto const stats = btck::get_memory_stats(btck::object_type::block)) {
+    EXPECT_GT(stats->live_objects, 0);
+  }
+}
+
+TEST(Block, ArchiveRegtest)
+{
+  auto const data = test::regtest_blocks();
+  auto raw_size = std::size_t{0};
+  auto archive = std::vector<std::byte>{};
+  auto writer = btck::archive_writer{[&](std::span<std::byte const> bytes) {
+    archive.insert(archive.end(), bytes.begin(), bytes.end());
+  }};
+  for (auto const& bytes : data) {
+    raw_size += bytes.size();
+    writer.append(btck::block{bytes});
+  }
+  writer.finish();
+  // At least the 30% the format is meant to save. Headers take 29% of the
+  // regtest blocks and signatures most of the rest, neither of which the
+  // dictionaries can shrink.
+  EXPECT_LT(archive.size(), raw_size * 7 / 10);
+
+  auto const reader = btck::archive_reader{archive};
+  ASSERT_EQ(reader.size(), data.size());
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    EXPECT_THAT(to_bytes(reader[i]), ::testing::ElementsAreArray(data[i]));
+  }
+}
+
+TEST(Block, ArchiveSegments)
+{
+  // Every block closes its segment, so references only reach values that
+  // repeat within the block, and later blocks store them again.
+  auto const data = test::regtest_blocks();
+  auto archive = std::vector<std::byte>{};
+  auto writer = btck::archive_writer{
+    [&](std::span<std::byte const> bytes) {
+      archive.insert(archive.end(), bytes.begin(), bytes.end());
+    },
+    1};
+  for (auto const& bytes : data) {
+    writer.append(btck::block{bytes});
+  }
+  writer.finish();
+
+  auto const reader = btck::archive_reader{archive};
+  ASSERT_EQ(reader.size(), data.size());
+  for (std::size_t i = data.size(); i-- > 0;) {
+    EXPECT_THAT(to_bytes(reader[i]), ::testing::ElementsAreArray(data[i]));
+  }
+  EXPECT_THROW((void)reader[data.size()], std::runtime_error);
+
+  auto empty = std::vector<std::byte>{};
+  auto empty_writer =
+    btck::archive_writer{[&](std::span<std::byte const> bytes) {
+      empty.insert(empty.end(), bytes.begin(), bytes.end());
+    }};
+  empty_writer.finish();
+  EXPECT_EQ(btck::archive_reader{empty}.size(), 0);
+}
+
+TEST(Block, FlatRegtest)
+{
+  for (auto const& bytes : test::regtest_blocks()) {
+    auto const flat = btck::flat_block{bytes};
+    auto const block = flat.to_block();
+    EXPECT_EQ(block.hash(), flat.hash());
+    EXPECT_THAT(to_bytes(block), ::testing::ElementsAreArray(bytes));
+  }
 }
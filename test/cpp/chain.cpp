@@ -0,0 +1,408 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <btck/btck.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <ranges>
+#include <stdexcept>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "regtest.hpp"
+
+namespace {
+
+auto read_le32(std::span<std::byte const> bytes) -> std::uint32_t
+{
+  auto value = std::uint32_t{0};
+  for (std::size_t i = 0; i < 4; ++i) {
+    value |= std::to_integer<std::uint32_t>(bytes[i]) << (8 * i);
+  }
+  return value;
+}
+
+// Writes the blocks the way Bitcoin Core stores them in blk?????.dat files:
+// the network magic, the little endian size and the serialized block.
+void write_block_file(
+  std::filesystem::path const& path,
+  std::vector<std::vector<std::byte>> const& blocks)
+{
+  static char const regtest_magic[] = {'\xfa', '\xbf', '\xb5', '\xda'};
+  auto file = std::ofstream{path, std::ios::binary};
+  for (auto const& block : blocks) {
+    auto const size = static_cast<std::uint32_t>(block.size());
+    char const size_bytes[] = {
+      static_cast<char>(size), static_cast<char>(size >> 8),
+      static_cast<char>(size >> 16), static_cast<char>(size >> 24)};
+    file.write(regtest_magic, sizeof(regtest_magic));
+    file.write(size_bytes, sizeof(size_bytes));
+    file.write(reinterpret_cast<char const*>(block.data()), block.size());
+  }
+  ASSERT_TRUE(file.flush());
+}
+
+// Creates a chain in `dir` and imports the regtest blocks into it.
+auto import_regtest(
+  std::filesystem::path const& dir, btck::Chain::KwArgs kwargs) -> btck::Chain
+{
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir / "import");
+  auto const paths = std::vector{(dir / "import" / "blk00000.dat").string()};
+  write_block_file(paths.front(), test::regtest_blocks());
+
+  auto chain = btck::Chain{
+    (dir / "data").string(), "",
+    std::move(kwargs)
+      .chain_type(btck::chain_type::regtest)
+      .SetBlockTreeDbInMemory(true)
+      .SetChainstateDbInMemory(true)};
+  EXPECT_EQ(chain.import_blocks(paths), std::size_t{0});
+  return chain;
+}
+
+}  // namespace
+
+TEST(Chain, ImportRegtest)
+{
+  auto const data = test::regtest_blocks();
+  auto const dir =
+    std::filesystem::path{::testing::TempDir()} / "btck_chain_import";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir / "import");
+  auto const paths = std::vector{(dir / "import" / "blk00000.dat").string()};
+  write_block_file(paths.front(), data);
+
+  {
+    auto chain = btck::Chain{
+      (dir / "data").string(), "",
+      btck::Chain::KwArgs{}
+        .chain_type(btck::chain_type::regtest)
+        .SetBlockTreeDbInMemory(true)
+        .SetChainstateDbInMemory(true)};
+
+    auto progress_total = std::size_t{0};
+    auto const skipped = chain.import_blocks(
+      paths, [&](std::size_t /*done*/, std::size_t total) {
+        progress_total = total;
+      });
+    EXPECT_EQ(skipped, std::size_t{0});
+    EXPECT_EQ(progress_total, data.size());
+    ASSERT_EQ(chain.size(), data.size());
+
+    auto const snapshot = chain.snapshot();
+    ASSERT_EQ(snapshot.size(), data.size() + 1);
+    for (std::size_t height = 1; height <= data.size(); ++height) {
+      auto const& bytes = data[height - 1];
+      auto const idx = static_cast<std::ptrdiff_t>(height);
+      auto const expected = btck::block{bytes};
+      EXPECT_EQ(snapshot.hash(height), expected.hash());
+      EXPECT_EQ(snapshot.find(expected.hash()) - snapshot.begin(), idx);
+      EXPECT_EQ(chain.find(expected.hash()) - chain.begin(), idx);
+
+      auto const header = chain.get_block_header(height);
+      auto const raw = std::span{bytes};
+      EXPECT_EQ(static_cast<std::uint32_t>(header.version), read_le32(raw));
+      EXPECT_TRUE(std::ranges::equal(
+        as_bytes(std::span{header.prev_hash.data}), raw.subspan(4, 32)));
+      EXPECT_TRUE(std::ranges::equal(
+        as_bytes(std::span{header.merkle_root}), raw.subspan(36, 32)));
+      EXPECT_EQ(header.time, read_le32(raw.subspan(68)));
+      EXPECT_EQ(header.bits, read_le32(raw.subspan(72)));
+      EXPECT_EQ(header.nonce, read_le32(raw.subspan(76)));
+
+      EXPECT_THAT(
+        chain.get_raw_block(height).bytes(),
+        ::testing::ElementsAreArray(bytes));
+
+      auto const block = chain[height];
+      EXPECT_THAT(to_bytes(block), ::testing::ElementsAreArray(bytes));
+      EXPECT_TRUE(chain.get_block_undo(height).verify_scripts(
+        block, btck::verification_flags::all));
+    }
+
+    auto expected_heights = std::vector<std::size_t>(data.size());
+    std::iota(expected_heights.begin(), expected_heights.end(), 1);
+
+    auto cursor = chain.read_ahead(1, data.size() + 1, 8);
+    auto cursor_heights = std::vector<std::size_t>{};
+    for (auto const& block : cursor) {
+      cursor_heights.push_back(static_cast<std::size_t>(
+        snapshot.find(block.hash()) - snapshot.begin()));
+    }
+    EXPECT_EQ(cursor_heights, expected_heights);
+
+    // Each shard is mapped by a single worker, so the shards need no lock.
+    constexpr auto shard_size = std::size_t{16};
+    auto shards = std::vector<std::vector<std::size_t>>(
+      (data.size() + shard_size - 1) / shard_size);
+    auto scan_heights = std::vector<std::size_t>{};
+    chain.parallel_scan(
+      1, data.size() + 1, shard_size,
+      [&](std::size_t shard, std::size_t height,
+          btck::unowned<btck::block> const& block) {
+        EXPECT_EQ(block.hash(), snapshot.hash(height));
+        shards.at(shard).push_back(height);
+      },
+      [&](std::size_t shard) {
+        scan_heights.insert(
+          scan_heights.end(), shards[shard].begin(), shards[shard].end());
+      });
+    EXPECT_EQ(scan_heights, expected_heights);
+  }
+
+  std::filesystem::remove_all(dir);
+}
+
+TEST(Chain, ImportCancel)
+{
+  auto const data = test::regtest_blocks();
+  auto const half = data.size() / 2;
+  auto const dir =
+    std::filesystem::path{::testing::TempDir()} / "btck_chain_import_cancel";
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir / "import");
+  auto const paths = std::vector{
+    (dir / "import" / "blk00000.dat").string(),
+    (dir / "import" / "blk00001.dat").string()};
+  write_block_file(paths[0], {data.begin(), data.begin() + half});
+  write_block_file(paths[1], {data.begin() + half, data.end()});
+
+  {
+    auto chain = btck::Chain{
+      (dir / "data").string(), "",
+      btck::Chain::KwArgs{}
+        .chain_type(btck::chain_type::regtest)
+        .SetBlockTreeDbInMemory(true)
+        .SetChainstateDbInMemory(true)};
+
+    // Each file is one batch, so cancelling after the first one leaves the
+    // blocks of the second file unconnected.
+    struct cancelled {};
+    auto calls = 0;
+    EXPECT_THROW(
+      chain.import_blocks(
+        paths,
+        [&](std::size_t done, std::size_t total) {
+          ++calls;
+          EXPECT_EQ(done, half);
+          EXPECT_EQ(total, data.size());
+          throw cancelled{};
+        }),
+      cancelled);
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(chain.size(), half);
+
+    EXPECT_EQ(chain.import_blocks(paths), std::size_t{0});
+    EXPECT_EQ(chain.size(), data.size());
+  }
+
+  std::filesystem::remove_all(dir);
+}
+
+TEST(Chain, BlockCache)
+{
+  auto const num_blocks = test::regtest_blocks().size();
+  auto const dir =
+    std::filesystem::path{::testing::TempDir()} / "btck_chain_block_cache";
+
+  {
+    // Room for a few of the small regtest blocks, not for all of them.
+    constexpr auto max_bytes = std::size_t{8192};
+    auto chain =
+      import_regtest(dir, btck::Chain::KwArgs{}.SetBlockCacheSize(max_bytes));
+
+    auto const before = chain.get_block_cache_stats();
+    auto const first = chain[1];
+    auto const missed = chain.get_block_cache_stats();
+    EXPECT_EQ(missed.misses, before.misses + 1);
+    EXPECT_GT(missed.entries, 0);
+
+    auto const again = chain[1];
+    auto const hit = chain.get_block_cache_stats();
+    EXPECT_EQ(hit.hits, missed.hits + 1);
+    EXPECT_EQ(hit.misses, missed.misses);
+    EXPECT_EQ(
+      again.transactions().front().get(), first.transactions().front().get());
+
+    for (std::size_t height = 1; height <= num_blocks; ++height) {
+      auto const block = chain[height];
+      EXPECT_LE(chain.get_block_cache_stats().bytes, max_bytes);
+    }
+    auto const full = chain.get_block_cache_stats();
+    EXPECT_GT(full.entries, 1);
+    EXPECT_LT(full.entries, num_blocks);
+
+    // The first block was evicted by the later ones.
+    auto const reread = chain[1];
+    EXPECT_EQ(chain.get_block_cache_stats().misses, full.misses + 1);
+  }
+
+  std::filesystem::remove_all(dir);
+}
+
+TEST(Chain, BlockIndexEntries)
+{
+  auto const data = test::regtest_blocks();
+  auto const dir =
+    std::filesystem::path{::testing::TempDir()} / "btck_chain_index_entries";
+
+  {
+    auto chain = import_regtest(dir, btck::Chain::KwArgs{});
+    auto const snapshot = chain.snapshot();
+    auto const entries = chain.get_block_index_entries(0, data.size() + 1);
+    ASSERT_EQ(entries.size(), data.size() + 1);
+    EXPECT_EQ(entries[0].height, 0);
+
+    for (std::size_t height = 1; height <= data.size(); ++height) {
+      auto const raw = std::span{data[height - 1]};
+      auto const entry = chain.get_block_index_entry(height);
+      EXPECT_EQ(entry.height, static_cast<std::int32_t>(height));
+      EXPECT_EQ(
+        btck::BlockHash{as_bytes(std::span{entry.hash.data})},
+        snapshot.hash(height));
+      EXPECT_TRUE(std::ranges::equal(
+        as_bytes(std::span{entry.prev_hash.data}), raw.subspan(4, 32)));
+      EXPECT_EQ(entry.time, read_le32(raw.subspan(68)));
+      EXPECT_EQ(
+        entry.num_transactions, btck::block{raw}.transactions().size());
+
+      auto const status = entry.status;
+      EXPECT_EQ(
+        status & BtcK_BlockStatus_VALID_MASK, BtcK_BlockStatus_VALID_SCRIPTS);
+      EXPECT_NE(status & BtcK_BlockStatus_HAVE_DATA, 0U);
+      EXPECT_NE(status & BtcK_BlockStatus_HAVE_UNDO, 0U);
+      EXPECT_EQ(
+        status &
+          (BtcK_BlockStatus_FAILED_VALID | BtcK_BlockStatus_FAILED_CHILD),
+        0U);
+
+      // Chain work is little endian, like uint256, and grows with every block.
+      auto const& prev = entries[height - 1];
+      EXPECT_TRUE(std::ranges::lexicographical_compare(
+        prev.chain_work | std::views::reverse,
+        entry.chain_work | std::views::reverse));
+
+      auto const& bulk = entries[height];
+      EXPECT_EQ(bulk.height, entry.height);
+      EXPECT_EQ(bulk.status, entry.status);
+      EXPECT_TRUE(std::ranges::equal(bulk.chain_work, entry.chain_work));
+    }
+
+    EXPECT_THROW(
+      static_cast<void>(chain.get_block_index_entry(data.size() + 1)),
+      std::runtime_error);
+    EXPECT_THROW(
+      static_cast<void>(chain.get_block_index_entries(1, data.size() + 2)),
+      std::runtime_error);
+  }
+
+  std::filesystem::remove_all(dir);
+}
+
+TEST(Chain, RawBlock)
+{
+  auto const data = test::regtest_blocks();
+  auto const dir =
+    std::filesystem::path{::testing::TempDir()} / "btck_chain_raw_block";
+
+  for (auto const obfuscate : {true, false}) {
+    auto chain = import_regtest(
+      dir, btck::Chain::KwArgs{}.SetObfuscateBlockFiles(obfuscate));
+    for (std::size_t height = 1; height <= data.size(); ++height) {
+      auto const raw = chain.get_raw_block(height);
+      EXPECT_THAT(raw.bytes(), ::testing::ElementsAreArray(data[height - 1]));
+#ifndef _WIN32
+      EXPECT_EQ(raw.is_mapped(), !obfuscate);
+#else
+      EXPECT_FALSE(raw.is_mapped());
+#endif
+    }
+  }
+
+  std::filesystem::remove_all(dir);
+}
+
+TEST(Chain, BlockFilePool)
+{
+  auto const data = test::regtest_blocks();
+  auto const dir =
+    std::filesystem::path{::testing::TempDir()} / "btck_chain_block_pool";
+  std::filesystem::remove_all(dir);
+
+  {
+    // More block files than open slots, and no block cache, so that readers
+    // keep evicting files the others still read from.
+    constexpr auto num_files = std::size_t{4};
+    auto chain = btck::Chain{
+      (dir / "data").string(), "",
+      btck::Chain::KwArgs{}
+        .chain_type(btck::chain_type::regtest)
+        .SetBlockTreeDbInMemory(true)
+        .SetChainstateDbInMemory(true)
+        .SetObfuscateBlockFiles(false)
+        .SetBlockCacheSize(0)
+        .SetMaxOpenBlockFiles(2)};
+
+    // The chain wrote the genesis block to blk00000.dat. Files after it in
+    // the blocks directory are indexed in place, not copied.
+    auto const blocks_dir = dir / "data" / "blocks";
+    auto const genesis_size =
+      std::filesystem::file_size(blocks_dir / "blk00000.dat");
+    auto paths = std::vector<std::string>{};
+    auto const per_file = (data.size() + num_files - 1) / num_files;
+    for (std::size_t file = 0; file < num_files; ++file) {
+      auto const first = std::min(file * per_file, data.size());
+      auto const last = std::min(first + per_file, data.size());
+      auto const name = "blk0000" + std::to_string(file + 1) + ".dat";
+      paths.push_back((blocks_dir / name).string());
+      write_block_file(
+        paths.back(), {data.begin() + first, data.begin() + last});
+    }
+    EXPECT_EQ(chain.import_blocks(paths), std::size_t{0});
+    ASSERT_EQ(chain.size(), data.size());
+    EXPECT_EQ(
+      std::filesystem::file_size(blocks_dir / "blk00000.dat"), genesis_size);
+    EXPECT_FALSE(std::filesystem::exists(blocks_dir / "blk00005.dat"));
+
+    // Each reader starts in a different file and wraps around.
+    constexpr auto num_readers = std::size_t{4};
+    auto failures = std::vector<std::size_t>(num_readers);
+    {
+      auto readers = std::vector<std::jthread>{};
+      for (std::size_t reader = 0; reader < num_readers; ++reader) {
+        readers.emplace_back([&, reader] {
+          for (std::size_t i = 0; i < data.size(); ++i) {
+            auto const height = (reader * per_file + i) % data.size() + 1;
+            auto const& bytes = data[height - 1];
+            try {
+              auto const raw = chain.get_raw_block(height);
+              auto const block = to_bytes(chain[height]);
+              if (!std::ranges::equal(raw.bytes(), bytes) ||
+                  !std::ranges::equal(block, bytes)) {
+                ++failures[reader];
+              }
+            }
+            catch (std::runtime_error const&) {
+              ++failures[reader];
+            }
+          }
+        });
+      }
+    }
+    EXPECT_THAT(failures, ::testing::Each(0));
+  }
+
+  std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,44 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace test {
+
+// Serialized regtest blocks at heights 1 to 206, each one building on the
+// previous one, read from the hex lines of test/data/regtest/blocks.txt.
+inline auto regtest_blocks() -> std::vector<std::vector<std::byte>>
+{
+  auto const nibble = [](char c) {
+    auto const digits = std::string_view{"0123456789abcdef"};
+    auto const pos = digits.find(c);
+    if (pos == std::string_view::npos) {
+      throw std::runtime_error("Invalid hex in regtest blocks.");
+    }
+    return static_cast<unsigned>(pos);
+  };
+
+  auto file = std::ifstream{BTCK_TEST_DATA_DIR "/regtest/blocks.txt"};
+  if (!file) {
+    throw std::runtime_error("Cannot open regtest blocks.");
+  }
+  auto blocks = std::vector<std::vector<std::byte>>{};
+  for (auto line = std::string{}; std::getline(file, line);) {
+    auto& block = blocks.emplace_back(line.size() / 2);
+    for (std::size_t i = 0; i < block.size(); ++i) {
+      block[i] = static_cast<std::byte>(
+        (nibble(line[2 * i]) << 4) | nibble(line[2 * i + 1]));
+    }
+  }
+  return blocks;
+}
+
+}  // namespace test
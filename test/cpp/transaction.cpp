@@ -7,6 +7,7 @@
 
 #include <btck/btck.hpp>
 #include <cstdint>
+#include <optional>
 #include <span>
 #include <string>
 
@@ -45,6 +46,27 @@ TEST(Transaction, Transaction)
   EXPECT_THAT(
     to_bytes(tx), ::testing::ElementsAreArray(as_bytes(std::span{data})));
 
+  auto const compressed = compress(tx.outputs().front());
+  EXPECT_EQ(compressed.size(), 25);
+  auto const txout = btck::transaction_output::decompress(compressed);
+  EXPECT_EQ(txout.amount(), 20737411);
+  EXPECT_EQ(txout.script_pubkey(), tx.outputs().front().script_pubkey());
+
+  auto shared = std::optional<btck::transaction_output>{};
+  {
+    auto const temporary = btck::transaction{as_bytes(std::span{data})};
+    shared = temporary.outputs().share(1);
+    EXPECT_EQ(
+      shared->script_pubkey().get(),
+      temporary.outputs()[1].script_pubkey().get());
+  }
+  EXPECT_EQ(shared->amount(), 42130042);
+  EXPECT_EQ(shared->script_pubkey(), tx.outputs().back().script_pubkey());
+  EXPECT_EQ(compress(*shared), compress(tx.outputs().back()));
+  EXPECT_EQ(to_string(*shared), to_string(tx.outputs().back()));
+  auto const shared_copy = *shared;
+  EXPECT_EQ(shared_copy.script_pubkey().get(), shared->script_pubkey().get());
+
   EXPECT_EQ(
     to_string(tx),
     R"(CTransaction(hash=aca326a724, ver=2, vin.size=1, vout.size=2, nLockTime=510826)